@@ -6,6 +6,10 @@
  *          and the program is aborted (i.e., the program exits abnormally). Assertions are intended purely as a
  *          development tool, and they should be disabled in release software. When disabled, every assertion provided
  *          here is equivalent to the expression `((void) 0)`.
+ *
+ *          This includes `megatech/assertions/slim.hpp` and, when `<format>` is available, it also includes
+ *          `megatech/assertions/format.hpp`. Translation units that don't use "format"-style assertions can include
+ *          the slim header directly to avoid parsing `<format>`.
  * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
  * @copyright AGPL-3.0-or-later
  * @date 2024
@@ -28,7 +32,9 @@
   /**
    * @def MEGATECH_ASSERTIONS_FORMAT_AVAILABLE
    * @brief If defined, "format"-style assertions will be enabled.
-   * @details This cannot be defined by clients.
+   * @details This cannot be defined by clients. It is defined by `megatech/assertions/format.hpp`, which
+   *          `megatech/assertions.hpp` includes whenever `<format>` is available. It is never defined by
+   *          `megatech/assertions/slim.hpp` alone.
    */
   #define MEGATECH_ASSERTIONS_FORMAT_AVAILABLE
 
@@ -42,10 +48,24 @@
   /**
    * @def MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT
    * @brief If defined, this forces the ::MEGATECH_ASSERT family of macros to use "format"-style formatting.
-   * @details This can be defined by clients, but only one default formatter can be used at a time.
+   * @details This can be defined by clients, but only one default formatter can be used at a time. If it's defined
+   *          when `megatech/assertions/slim.hpp` is included, ::MEGATECH_ASSERT_MSG and the other default formatter
+   *          macros aren't defined until `megatech/assertions/format.hpp` is included.
    */
   #define MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT
 
+  /**
+   * @def MEGATECH_ASSERTIONS_DEFERRED_FORMAT
+   * @brief If defined, "format"-style assertions copy their arguments into a compact encoding instead of type-erasing
+   *        them with `std::make_format_args`.
+   * @details This can be defined by clients. A failing assertion only copies its arguments' bytes, along with a type
+   *          tag for each argument, and the library formats them in one central routine. This means that
+   *          `std::format` machinery is never instantiated at the assertion site. Only `bool`, character, integer,
+   *          floating point, string (`const char*` or `std::string_view`), and pointer arguments are supported.
+   *          Dynamic widths and precisions (e.g., `"{:{}}"`) are not supported.
+   */
+  #define MEGATECH_ASSERTIONS_DEFERRED_FORMAT
+
   /**
    * @def MEGATECH_ASSERTIONS_DISABLED
    * @brief If defined, assertions are disabled **as-if** `NDEBUG` was defined.
@@ -67,6 +87,127 @@
    */
   #define MEGATECH_ASSERTIONS_ENABLED
 
+  /**
+   * @def MEGATECH_ASSERTIONS_LEVEL_OFF
+   * @brief The assertion level that eliminates every hard assertion.
+   * @see ::MEGATECH_ASSERTIONS_LEVEL
+   */
+  #define MEGATECH_ASSERTIONS_LEVEL_OFF (0)
+
+  /**
+   * @def MEGATECH_ASSERTIONS_LEVEL_DEFAULT
+   * @brief The assertion level that enables ::MEGATECH_ASSERT, preconditions, postconditions, and sampled assertions.
+   * @see ::MEGATECH_ASSERTIONS_LEVEL
+   */
+  #define MEGATECH_ASSERTIONS_LEVEL_DEFAULT (1)
+
+  /**
+   * @def MEGATECH_ASSERTIONS_LEVEL_AUDIT
+   * @brief The assertion level that enables ::MEGATECH_ASSERT_AUDIT in addition to every default assertion.
+   * @see ::MEGATECH_ASSERTIONS_LEVEL
+   */
+  #define MEGATECH_ASSERTIONS_LEVEL_AUDIT (2)
+
+  /**
+   * @def MEGATECH_ASSERTIONS_LEVEL
+   * @brief The highest level of hard assertions that are compiled into the program.
+   * @details This can be defined by clients. It **MUST** be one of ::MEGATECH_ASSERTIONS_LEVEL_OFF,
+   *          ::MEGATECH_ASSERTIONS_LEVEL_DEFAULT, or ::MEGATECH_ASSERTIONS_LEVEL_AUDIT. When it isn't defined, it is
+   *          ::MEGATECH_ASSERTIONS_LEVEL_DEFAULT if ::MEGATECH_ASSERTIONS_ENABLED is defined and
+   *          ::MEGATECH_ASSERTIONS_LEVEL_OFF otherwise. Defining any level above ::MEGATECH_ASSERTIONS_LEVEL_OFF
+   *          implies ::MEGATECH_ASSERTIONS_ENABLED. Soft assertions and axioms aren't affected by the level.
+   */
+  #define MEGATECH_ASSERTIONS_LEVEL
+
+  /**
+   * @def MEGATECH_ASSERTIONS_CATEGORIES
+   * @brief A bitmask of the assertion categories that are compiled into the program.
+   * @details This can be defined by clients. A categorized assertion (e.g., ::MEGATECH_ASSERT_IN) is compiled in only
+   *          if its category shares at least one bit with this mask. It **MUST** be a constant expression convertible
+   *          to `std::uint_least64_t`. When it isn't defined, every category is enabled. The mask only filters
+   *          categorized assertions. It never enables assertions on its own.
+   */
+  #define MEGATECH_ASSERTIONS_CATEGORIES
+
+  /**
+   * @def MEGATECH_ASSERTIONS_STATIC_SITES_UNAVAILABLE
+   * @brief If defined, assertion sites will be created as temporaries on failure instead of as static objects.
+   * @details This can be defined by clients. It is also defined automatically when the compiler doesn't support GNU
+   *          statement expressions.
+   * @see megatech::assertion_site
+   */
+  #define MEGATECH_ASSERTIONS_STATIC_SITES_UNAVAILABLE
+
+  /**
+   * @def MEGATECH_ASSERTIONS_STATIC_SITES_AVAILABLE
+   * @brief If defined, every assertion macro expansion creates one `static constexpr` ::megatech::assertion_site.
+   * @details This cannot be defined by clients.
+   */
+  #define MEGATECH_ASSERTIONS_STATIC_SITES_AVAILABLE
+
+  /**
+   * @def MEGATECH_ASSERTIONS_SITE_REGISTRY_AVAILABLE
+   * @brief If defined, static assertion sites are collected by the linker and megatech::assertion_sites() lists them.
+   * @details This requires ::MEGATECH_ASSERTIONS_STATIC_SITES_AVAILABLE and an ELF target. This cannot be defined by
+   *          clients. GCC versions prior to 14 ignore section placement for sites in template instantiations, so those
+   *          sites aren't registered.
+   */
+  #define MEGATECH_ASSERTIONS_SITE_REGISTRY_AVAILABLE
+
+  /**
+   * @def MEGATECH_ASSERTIONS_RUNTIME_TOGGLES
+   * @brief If defined, every assertion checks its site's megatech::assertion_site::enabled flag before evaluating its
+   *        expression.
+   * @details This can be defined by clients. It requires ::MEGATECH_ASSERTIONS_STATIC_SITES_AVAILABLE. The check is a
+   *          single relaxed atomic load. Disabled assertions don't evaluate their expressions or message parameters.
+   *          When ::MEGATECH_ASSERTIONS_SITE_REGISTRY_AVAILABLE is also defined, the `MEGATECH_ASSERTIONS_TOGGLES`
+   *          environment variable is applied to every registered site once during static initialization.
+   * @see megatech::configure_assertions()
+   */
+  #define MEGATECH_ASSERTIONS_RUNTIME_TOGGLES
+
+  /**
+   * @def MEGATECH_ASSERTIONS_COMPACT_SITES
+   * @brief If defined, assertion sites don't contain any file, function, or expression strings.
+   * @details This can be defined by clients. It requires ::MEGATECH_ASSERTIONS_STATIC_SITES_AVAILABLE and an ELF
+   *          target. Each site is identified by a 32-bit megatech::assertion_site::id, and reports only include that
+   *          ID. The strings are written to the `megatech_assertion_symbols` section instead. That section is never
+   *          read at run-time, so it can be extracted into a side table and removed from the binary. The
+   *          `megatech-assertions-symbolize` tool maps IDs back to their sites. Run-time toggle patterns never match
+   *          compact sites.
+   */
+  #define MEGATECH_ASSERTIONS_COMPACT_SITES
+
+  /**
+   * @def MEGATECH_ASSERTIONS_PROFILING
+   * @brief If defined, every assertion counts how many times its expression is evaluated.
+   * @details This can be defined by clients. It requires ::MEGATECH_ASSERTIONS_STATIC_SITES_AVAILABLE. Each thread
+   *          claims one megatech::assertion_profile per site the first time that it evaluates the site, and only that
+   *          thread ever writes to it. A report of every profile, sorted by cost, is written to standard error when
+   *          the program exits and whenever megatech::write_assertion_profile() is called.
+   */
+  #define MEGATECH_ASSERTIONS_PROFILING
+
+  /**
+   * @def MEGATECH_ASSERTIONS_PROFILE_CYCLES
+   * @brief If defined, profiled assertions also measure the time spent evaluating their expressions.
+   * @details This can be defined by clients. It requires ::MEGATECH_ASSERTIONS_PROFILING. On x86 targets, time is
+   *          measured in time stamp counter cycles. Elsewhere, it is measured in `std::chrono::steady_clock` ticks.
+   *          The counter isn't serialized, so very cheap expressions are only measured approximately.
+   */
+  #define MEGATECH_ASSERTIONS_PROFILE_CYCLES
+
+  /**
+   * @def MEGATECH_ASSERTIONS_ASSUME_CONTRACTS
+   * @brief If defined, disabled preconditions and postconditions are lowered to optimizer hints.
+   * @details This can be defined by clients. When assertions are disabled, every ::MEGATECH_PRECONDITION and
+   *          ::MEGATECH_POSTCONDITION behaves like ::MEGATECH_ASSUME. When assertions are enabled, this has no effect.
+   *          Contracts that are false at run-time result in undefined behavior, so they should be verified in debug
+   *          builds before this is used. Unlike ::MEGATECH_ASSUME, contracts are never evaluated. Compilers without
+   *          a non-evaluating assumption (e.g., GCC before version 13) ignore them instead.
+   */
+  #define MEGATECH_ASSERTIONS_ASSUME_CONTRACTS
+
   /**
    * @def MEGATECH_ASSERT_MSG
    * @brief Assert that an expression is true and provide a diagnostic message if it is false.
@@ -74,8 +215,8 @@
    *          ::MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_PRINTF and ::MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT to
    *          determine which syntax is the default.
    * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
-   * @param msg A diagnostic message format to render and display if the assertion fails. This **SHOULD** be a string
-   *            literal. Other types of inputs are not recommended even if they produce the expected results.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
    * @param ... 0 or more parameters to use in rendering the diagnostic message.
    */
   #define MEGATECH_ASSERT_MSG(exp, msg, ...)
@@ -85,8 +226,8 @@
    * @brief Assert that an expression is true and provide a diagnostic message if it is false.
    * @details This variant always uses the "printf"-style format syntax.
    * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
-   * @param msg A diagnostic message format to render and display if the assertion fails. This **SHOULD** be a string
-   *            literal. Other types of inputs are not recommended even if they produce the expected results.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
    * @param ... 0 or more parameters to use in rendering the diagnostic message.
    * @see ::MEGATECH_ASSERT_MSG
    */
@@ -97,8 +238,8 @@
    * @brief Assert that an expression is true and provide a diagnostic message if it is false.
    * @details This variant always uses the "format"-style format syntax.
    * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
-   * @param msg A diagnostic message format to render and display if the assertion fails. This **SHOULD** be a string
-   *            literal. Other types of inputs are not recommended even if they produce the expected results.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
    * @param ... 0 or more parameters to use in rendering the diagnostic message.
    * @see ::MEGATECH_ASSERT_MSG
    */
@@ -112,14 +253,312 @@
    */
   #define MEGATECH_ASSERT(exp)
 
+  /**
+   * @def MEGATECH_ASSERT_EQ
+   * @brief Assert that two values are equal.
+   * @details Each operand is evaluated exactly once and bound by reference, so a passing assertion only performs the
+   *          comparison. When the assertion fails, the operand values are rendered into the diagnostic message (e.g.,
+   *          `3 == 4`). Operands are rendered with `std::formatter` if it is available for both types. Otherwise,
+   *          bool, character, integer, enumeration, floating point, string, and pointer operands are rendered with
+   *          the "printf"-style syntax and any other operand is rendered as `(unformattable)`.
+   * @param a The left operand.
+   * @param b The right operand.
+   */
+  #define MEGATECH_ASSERT_EQ(a, b)
+
+  /**
+   * @def MEGATECH_ASSERT_NE
+   * @brief Assert that two values are not equal.
+   * @param a The left operand.
+   * @param b The right operand.
+   * @see ::MEGATECH_ASSERT_EQ
+   */
+  #define MEGATECH_ASSERT_NE(a, b)
+
+  /**
+   * @def MEGATECH_ASSERT_LT
+   * @brief Assert that one value is less than another.
+   * @param a The left operand.
+   * @param b The right operand.
+   * @see ::MEGATECH_ASSERT_EQ
+   */
+  #define MEGATECH_ASSERT_LT(a, b)
+
+  /**
+   * @def MEGATECH_ASSERT_LE
+   * @brief Assert that one value is less than or equal to another.
+   * @param a The left operand.
+   * @param b The right operand.
+   * @see ::MEGATECH_ASSERT_EQ
+   */
+  #define MEGATECH_ASSERT_LE(a, b)
+
+  /**
+   * @def MEGATECH_ASSERT_GT
+   * @brief Assert that one value is greater than another.
+   * @param a The left operand.
+   * @param b The right operand.
+   * @see ::MEGATECH_ASSERT_EQ
+   */
+  #define MEGATECH_ASSERT_GT(a, b)
+
+  /**
+   * @def MEGATECH_ASSERT_GE
+   * @brief Assert that one value is greater than or equal to another.
+   * @param a The left operand.
+   * @param b The right operand.
+   * @see ::MEGATECH_ASSERT_EQ
+   */
+  #define MEGATECH_ASSERT_GE(a, b)
+
+  /**
+   * @def MEGATECH_ASSERT_AUDIT_MSG
+   * @brief Assert that an expensive expression is true and provide a diagnostic message if it is false.
+   * @details This uses the default formatting syntax.
+   * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
+   * @param ... 0 or more parameters to use in rendering the diagnostic message.
+   * @see ::MEGATECH_ASSERT_AUDIT
+   */
+  #define MEGATECH_ASSERT_AUDIT_MSG(exp, msg, ...)
+
+  /**
+   * @def MEGATECH_ASSERT_AUDIT_MSG_PRINTF
+   * @brief Assert that an expensive expression is true and provide a diagnostic message if it is false.
+   * @details This variant always uses the "printf"-style format syntax.
+   * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
+   * @param ... 0 or more parameters to use in rendering the diagnostic message.
+   * @see ::MEGATECH_ASSERT_AUDIT
+   */
+  #define MEGATECH_ASSERT_AUDIT_MSG_PRINTF(exp, msg, ...)
+
+  /**
+   * @def MEGATECH_ASSERT_AUDIT_MSG_FORMAT
+   * @brief Assert that an expensive expression is true and provide a diagnostic message if it is false.
+   * @details This variant always uses the "format"-style format syntax.
+   * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
+   * @param ... 0 or more parameters to use in rendering the diagnostic message.
+   * @see ::MEGATECH_ASSERT_AUDIT
+   */
+  #define MEGATECH_ASSERT_AUDIT_MSG_FORMAT(exp, msg, ...)
+
+  /**
+   * @def MEGATECH_ASSERT_AUDIT
+   * @brief Assert that an expensive expression is true.
+   * @details Audit assertions are intended for checks that are too expensive for the default level (e.g., checking
+   *          that a range is sorted). They behave exactly like ::MEGATECH_ASSERT, but they are only compiled in when
+   *          ::MEGATECH_ASSERTIONS_LEVEL is at least ::MEGATECH_ASSERTIONS_LEVEL_AUDIT.
+   * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
+   */
+  #define MEGATECH_ASSERT_AUDIT(exp)
+
+  /**
+   * @def MEGATECH_ASSUME
+   * @brief Assert that an expression is true and allow the optimizer to rely on it.
+   * @details When assertions are enabled, this is equivalent to ::MEGATECH_ASSERT, so every assumption is verified
+   *          in debug builds. When assertions are disabled, this becomes an optimizer hint (i.e., `[[assume(exp)]]`,
+   *          `__builtin_assume(exp)`, or `__builtin_unreachable()` when the expression is false). If the expression
+   *          is false at run-time the behavior is undefined. Depending on the compiler, the expression may still be
+   *          evaluated, so it **MUST NOT** have side effects.
+   * @param exp The assumption's controlling expression. This **MUST** be convertible to `bool`.
+   */
+  #define MEGATECH_ASSUME(exp)
+
+  /**
+   * @def MEGATECH_ASSERT_AXIOM
+   * @brief Assert that an expression is true without ever evaluating it.
+   * @details Axioms document conditions that can't (or shouldn't) be checked at run-time (e.g., that a pointer refers
+   *          to a live object). The expression is never evaluated at any assertion level, but it **MUST** still be
+   *          well-formed.
+   * @param exp The axiom's expression. This **MUST** be convertible to `bool`.
+   */
+  #define MEGATECH_ASSERT_AXIOM(exp)
+
+  /**
+   * @def MEGATECH_ASSERT_SAMPLED_MSG
+   * @brief Assert that an expression is true on every nth pass and provide a diagnostic message if it is false.
+   * @details This uses the default formatting syntax.
+   * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
+   * @param n The sampling period.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
+   * @param ... 0 or more parameters to use in rendering the diagnostic message.
+   * @see ::MEGATECH_ASSERT_SAMPLED
+   */
+  #define MEGATECH_ASSERT_SAMPLED_MSG(exp, n, msg, ...)
+
+  /**
+   * @def MEGATECH_ASSERT_SAMPLED_MSG_PRINTF
+   * @brief Assert that an expression is true on every nth pass and provide a diagnostic message if it is false.
+   * @details This variant always uses the "printf"-style format syntax.
+   * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
+   * @param n The sampling period.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
+   * @param ... 0 or more parameters to use in rendering the diagnostic message.
+   * @see ::MEGATECH_ASSERT_SAMPLED
+   */
+  #define MEGATECH_ASSERT_SAMPLED_MSG_PRINTF(exp, n, msg, ...)
+
+  /**
+   * @def MEGATECH_ASSERT_SAMPLED_MSG_FORMAT
+   * @brief Assert that an expression is true on every nth pass and provide a diagnostic message if it is false.
+   * @details This variant always uses the "format"-style format syntax.
+   * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
+   * @param n The sampling period.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
+   * @param ... 0 or more parameters to use in rendering the diagnostic message.
+   * @see ::MEGATECH_ASSERT_SAMPLED
+   */
+  #define MEGATECH_ASSERT_SAMPLED_MSG_FORMAT(exp, n, msg, ...)
+
+  /**
+   * @def MEGATECH_ASSERT_SAMPLED
+   * @brief Assert that an expression is true on every nth pass.
+   * @details The expression is evaluated on the first pass and then once every `n` passes. Other passes don't evaluate
+   *          the expression at all. Each assertion keeps a separate countdown on each thread, so sampling never
+   *          shares memory between threads. When `n` is a power of two, the countdown is a single mask test. If `n` is
+   *          0 or 1, the expression is evaluated on every pass.
+   * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
+   * @param n The sampling period. This **MUST** be convertible to `std::uint_least32_t`.
+   */
+  #define MEGATECH_ASSERT_SAMPLED(exp, n)
+
+  /**
+   * @def MEGATECH_ASSERT_IN_MSG
+   * @brief Assert that an expression in a category is true and provide a diagnostic message if it is false.
+   * @details This uses the default formatting syntax.
+   * @param category The assertion's category.
+   * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
+   * @param ... 0 or more parameters to use in rendering the diagnostic message.
+   * @see ::MEGATECH_ASSERT_IN
+   */
+  #define MEGATECH_ASSERT_IN_MSG(category, exp, msg, ...)
+
+  /**
+   * @def MEGATECH_ASSERT_IN_MSG_PRINTF
+   * @brief Assert that an expression in a category is true and provide a diagnostic message if it is false.
+   * @details This variant always uses the "printf"-style format syntax.
+   * @param category The assertion's category.
+   * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
+   * @param ... 0 or more parameters to use in rendering the diagnostic message.
+   * @see ::MEGATECH_ASSERT_IN
+   */
+  #define MEGATECH_ASSERT_IN_MSG_PRINTF(category, exp, msg, ...)
+
+  /**
+   * @def MEGATECH_ASSERT_IN_MSG_FORMAT
+   * @brief Assert that an expression in a category is true and provide a diagnostic message if it is false.
+   * @details This variant always uses the "format"-style format syntax.
+   * @param category The assertion's category.
+   * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
+   * @param ... 0 or more parameters to use in rendering the diagnostic message.
+   * @see ::MEGATECH_ASSERT_IN
+   */
+  #define MEGATECH_ASSERT_IN_MSG_FORMAT(category, exp, msg, ...)
+
+  /**
+   * @def MEGATECH_ASSERT_IN
+   * @brief Assert that an expression in a category is true.
+   * @details Categories are client-defined bitmasks, usually one bit per module. When the category doesn't share a
+   *          bit with ::MEGATECH_ASSERTIONS_CATEGORIES, the expression is never evaluated and no code is generated
+   *          for it. Otherwise, this behaves exactly like ::MEGATECH_ASSERT, including run-time toggles.
+   * @param category The assertion's category. This **MUST** be a constant expression of integral or enumeration type.
+   * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
+   */
+  #define MEGATECH_ASSERT_IN(category, exp)
+
+  /**
+   * @def MEGATECH_ASSERT_CONTEXT
+   * @brief Describe the current scope in every assertion failure report on the calling thread until the scope ends.
+   * @details This declares a local variable, so it can only be used as a statement. Nothing is formatted unless an
+   *          assertion fails. The scope only copies its arguments and pushes a pointer onto a fixed-size per-thread
+   *          stack of megatech::assertion_context. The default failure handler formats the whole stack after each
+   *          report, from the outermost scope to the innermost. Arguments are restricted like those of deferred
+   *          formatting, and strings are referenced rather than copied, so they must outlive the scope. This always
+   *          uses the "format"-style format syntax.
+   * @param msg A description of the scope to render if an assertion fails. This **MUST** be a string literal or a
+   *            constant expression convertible to `const char*`.
+   * @param ... 0 or more parameters to use in rendering the description.
+   */
+  #define MEGATECH_ASSERT_CONTEXT(msg, ...)
+
+  /**
+   * @def MEGATECH_ASSERTIONS_SOFT_DISABLED
+   * @brief If defined, soft assertions are eliminated.
+   * @details This can be defined by clients. Soft assertions are intended for production software, so they aren't
+   *          affected by `NDEBUG`, ::MEGATECH_ASSERTIONS_DISABLED, or ::MEGATECH_ASSERTIONS_ENABLED.
+   * @see ::MEGATECH_SOFT_ASSERT
+   */
+  #define MEGATECH_ASSERTIONS_SOFT_DISABLED
+
+  /**
+   * @def MEGATECH_SOFT_ASSERT_MSG
+   * @brief Softly assert that an expression is true and provide a diagnostic message if it is false.
+   * @details This uses the default formatting syntax.
+   * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
+   * @param ... 0 or more parameters to use in rendering the diagnostic message.
+   * @see ::MEGATECH_SOFT_ASSERT
+   */
+  #define MEGATECH_SOFT_ASSERT_MSG(exp, msg, ...)
+
+  /**
+   * @def MEGATECH_SOFT_ASSERT_MSG_PRINTF
+   * @brief Softly assert that an expression is true and provide a diagnostic message if it is false.
+   * @details This variant always uses the "printf"-style format syntax.
+   * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
+   * @param ... 0 or more parameters to use in rendering the diagnostic message.
+   * @see ::MEGATECH_SOFT_ASSERT
+   */
+  #define MEGATECH_SOFT_ASSERT_MSG_PRINTF(exp, msg, ...)
+
+  /**
+   * @def MEGATECH_SOFT_ASSERT_MSG_FORMAT
+   * @brief Softly assert that an expression is true and provide a diagnostic message if it is false.
+   * @details This variant always uses the "format"-style format syntax.
+   * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
+   * @param ... 0 or more parameters to use in rendering the diagnostic message.
+   * @see ::MEGATECH_SOFT_ASSERT
+   */
+  #define MEGATECH_SOFT_ASSERT_MSG_FORMAT(exp, msg, ...)
+
+  /**
+   * @def MEGATECH_SOFT_ASSERT
+   * @brief Softly assert that an expression is true.
+   * @details Soft assertions don't abort the program. Instead, a failing soft assertion increments its site's failure
+   *          counter. The first few failures at each site are also reported on the standard error stream. The exact
+   *          number is configured when the library is built. Counters are updated without locking.
+   * @param exp The assertion's controlling expression. This **MUST** be convertible to `bool`.
+   * @see megatech::soft_assertion_failures()
+   */
+  #define MEGATECH_SOFT_ASSERT(exp)
+
   /**
    * @def MEGATECH_PRECONDITION_MSG
    * @brief Assert that a precondition is true and provide a diagnostic message if it is false.
    * @details Precondition macros behave identically to assertion macros. They exist merely to clarify the purpose
    *          of precondition assertions.
    * @param exp The precondition's controlling expression. This **MUST** be convertible to `bool`.
-   * @param msg A diagnostic message format to render and display if the assertion fails. This **SHOULD** be a string
-   *            literal. Other types of inputs are not recommended even if they produce the expected results.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
    * @param ... 0 or more parameters to use in rendering the diagnostic message.
    * @see MEGATECH_ASSERT_MSG
    */
@@ -131,8 +570,8 @@
    * @details Precondition macros behave identically to assertion macros. They exist merely to clarify the purpose
    *          of precondition assertions. This variant always uses the "printf"-style format syntax.
    * @param exp The precondition's controlling expression. This **MUST** be convertible to `bool`.
-   * @param msg A diagnostic message format to render and display if the assertion fails. This **SHOULD** be a string
-   *            literal. Other types of inputs are not recommended even if they produce the expected results.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
    * @param ... 0 or more parameters to use in rendering the diagnostic message.
    * @see MEGATECH_ASSERT_MSG
    */
@@ -144,8 +583,8 @@
    * @details Precondition macros behave identically to assertion macros. They exist merely to clarify the purpose
    *          of precondition assertions. This variant always uses the "format"-style format syntax.
    * @param exp The precondition's controlling expression. This **MUST** be convertible to `bool`.
-   * @param msg A diagnostic message format to render and display if the assertion fails. This **SHOULD** be a string
-   *            literal. Other types of inputs are not recommended even if they produce the expected results.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
    * @param ... 0 or more parameters to use in rendering the diagnostic message.
    * @see MEGATECH_ASSERT_MSG
    */
@@ -166,8 +605,8 @@
    * @details Postcondition macros behave identically to assertion macros. They exist merely to clarify the purpose
    *          of postcondition assertions.
    * @param exp The postcondition's controlling expression. This **MUST** be convertible to `bool`.
-   * @param msg A diagnostic message format to render and display if the assertion fails. This **SHOULD** be a string
-   *            literal. Other types of inputs are not recommended even if they produce the expected results.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
    * @param ... 0 or more parameters to use in rendering the diagnostic message.
    * @see MEGATECH_ASSERT_MSG
    */
@@ -179,8 +618,8 @@
    * @details Postcondition macros behave identically to assertion macros. They exist merely to clarify the purpose
    *          of postcondition assertions. This variant always uses the "printf"-style format syntax.
    * @param exp The postcondition's controlling expression. This **MUST** be convertible to `bool`.
-   * @param msg A diagnostic message format to render and display if the assertion fails. This **SHOULD** be a string
-   *            literal. Other types of inputs are not recommended even if they produce the expected results.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
    * @param ... 0 or more parameters to use in rendering the diagnostic message.
    * @see MEGATECH_ASSERT_MSG
    */
@@ -192,8 +631,8 @@
    * @details Postcondition macros behave identically to assertion macros. They exist merely to clarify the purpose
    *          of postcondition assertions. This variant always uses the "format"-style format syntax.
    * @param exp The postcondition's controlling expression. This **MUST** be convertible to `bool`.
-   * @param msg A diagnostic message format to render and display if the assertion fails. This **SHOULD** be a string
-   *            literal. Other types of inputs are not recommended even if they produce the expected results.
+   * @param msg A diagnostic message format to render and display if the assertion fails. This **MUST** be a string
+   *            literal or a constant expression convertible to `const char*`.
    * @param ... 0 or more parameters to use in rendering the diagnostic message.
    * @see MEGATECH_ASSERT_MSG
    */
@@ -217,11 +656,46 @@
   #undef MEGATECH_ASSERTIONS_FORMAT_UNAVAILABLE
   #undef MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_PRINTF
   #undef MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT
+  #undef MEGATECH_ASSERTIONS_DEFERRED_FORMAT
   #undef MEGATECH_ASSERTIONS_DISABLED
+  #undef MEGATECH_ASSERTIONS_STATIC_SITES_UNAVAILABLE
+  #undef MEGATECH_ASSERTIONS_RUNTIME_TOGGLES
+  #undef MEGATECH_ASSERTIONS_COMPACT_SITES
+  #undef MEGATECH_ASSERTIONS_PROFILING
+  #undef MEGATECH_ASSERTIONS_PROFILE_CYCLES
   #undef MEGATECH_ASSERT_MSG
   #undef MEGATECH_ASSERT_MSG_PRINTF
   #undef MEGATECH_ASSERT_MSG_FORMAT
   #undef MEGATECH_ASSERT
+  #undef MEGATECH_ASSERT_EQ
+  #undef MEGATECH_ASSERT_NE
+  #undef MEGATECH_ASSERT_LT
+  #undef MEGATECH_ASSERT_LE
+  #undef MEGATECH_ASSERT_GT
+  #undef MEGATECH_ASSERT_GE
+  #undef MEGATECH_ASSERTIONS_LEVEL
+  #undef MEGATECH_ASSERTIONS_CATEGORIES
+  #undef MEGATECH_ASSERT_AUDIT_MSG
+  #undef MEGATECH_ASSERT_AUDIT_MSG_PRINTF
+  #undef MEGATECH_ASSERT_AUDIT_MSG_FORMAT
+  #undef MEGATECH_ASSERT_AUDIT
+  #undef MEGATECH_ASSERT_AXIOM
+  #undef MEGATECH_ASSERTIONS_ASSUME_CONTRACTS
+  #undef MEGATECH_ASSUME
+  #undef MEGATECH_ASSERT_SAMPLED_MSG
+  #undef MEGATECH_ASSERT_SAMPLED_MSG_PRINTF
+  #undef MEGATECH_ASSERT_SAMPLED_MSG_FORMAT
+  #undef MEGATECH_ASSERT_SAMPLED
+  #undef MEGATECH_ASSERT_IN_MSG
+  #undef MEGATECH_ASSERT_IN_MSG_PRINTF
+  #undef MEGATECH_ASSERT_IN_MSG_FORMAT
+  #undef MEGATECH_ASSERT_IN
+  #undef MEGATECH_ASSERT_CONTEXT
+  #undef MEGATECH_ASSERTIONS_SOFT_DISABLED
+  #undef MEGATECH_SOFT_ASSERT_MSG
+  #undef MEGATECH_SOFT_ASSERT_MSG_PRINTF
+  #undef MEGATECH_SOFT_ASSERT_MSG_FORMAT
+  #undef MEGATECH_SOFT_ASSERT
   #undef MEGATECH_PRECONDITION_MSG
   #undef MEGATECH_PRECONDITION_MSG_PRINTF
   #undef MEGATECH_PRECONDITION_MSG_FORMAT
@@ -232,202 +706,46 @@
   #undef MEGATECH_POSTCONDITION
 
   #include <cstddef>
+  #include <cstdint>
+  #include <cstring>
 
+  #include <array>
+  #include <atomic>
+  #include <bit>
+  #include <initializer_list>
   #include <source_location>
+  #include <span>
   #include <string_view>
+  #include <type_traits>
+  #include <utility>
   #include <format>
+  #include <x86intrin.h>
+  #include <chrono>
 #endif
 
 /// @cond
-#if __has_include(<format>)
-  #ifndef MEGATECH_ASSERTIONS_FORMAT_UNAVAILABLE
-    #define MEGATECH_ASSERTIONS_FORMAT_AVAILABLE (1)
-  #endif
-#elif !defined(MEGATECH_ASSERTIONS_FORMAT_UNAVAILABLE)
-  #define MEGATECH_ASSERTIONS_FORMAT_UNAVAILABLE (1)
-#endif
-
-#if !defined(MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_PRINTF) && !defined(MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT)
-  #ifdef MEGATECH_ASSERTIONS_FORMAT_AVAILABLE
+#if __has_include(<format>) && !defined(MEGATECH_ASSERTIONS_FORMAT_UNAVAILABLE)
+  // This only chooses the default formatter if no assertion header was included earlier.
+  #if !defined(MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_PRINTF) && !defined(MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT)
     #define MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT (1)
-  #else
-    #define MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_PRINTF (1)
-  #endif
-#elif defined(MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_PRINTF) && defined(MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT)
-  #error "Only one formatter can be used as the default formatter."
-#elif defined(MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT) && !defined(MEGATECH_ASSERTIONS_FORMAT_AVAILABLE)
-  #error "<format> based assertions are not available."
-#endif
-
-#ifndef MEGATECH_ASSERTIONS_ENABLED
-  #if !defined(MEGATECH_ASSERTIONS_DISABLED) && !defined(NDEBUG)
-    #define MEGATECH_ASSERTIONS_ENABLED (1)
   #endif
-#endif
-
-#if defined(MEGATECH_ASSERTIONS_ENABLED) && defined(MEGATECH_ASSERTIONS_DISABLED)
-  #error "Assertions cannot be enabled and disabled at the same time."
-#endif
-
-#include <source_location>
-#include <string_view>
-
-#ifdef MEGATECH_ASSERTIONS_FORMAT_AVAILABLE
-  #include <format>
-#endif
-
-#ifdef MEGATECH_ASSERTIONS_ENABLED
-  #define MEGATECH_ASSERT_MSG_PRINTF(exp, msg, ...) \
-    (megatech::debug_assertion_printf(std::source_location::current(), (exp), (#exp), (msg) __VA_OPT__(,) __VA_ARGS__))
-  #define MEGATECH_PRECONDITION_MSG_PRINTF(exp, msg, ...) \
-    MEGATECH_ASSERT_MSG_PRINTF(exp, msg __VA_OPT__(,) __VA_ARGS__)
-  #define MEGATECH_POSTCONDITION_MSG_PRINTF(exp, msg, ...) \
-    MEGATECH_ASSERT_MSG_PRINTF(exp, msg __VA_OPT__(,) __VA_ARGS__)
-  #ifdef MEGATECH_ASSERTIONS_FORMAT_AVAILABLE
-    #define MEGATECH_ASSERT_MSG_FORMAT(exp, msg, ...) \
-      (megatech::debug_assertion_format(std::source_location::current(), (exp), (#exp), (msg) __VA_OPT__(,) __VA_ARGS__))
-    #define MEGATECH_PRECONDITION_MSG_FORMAT(exp, msg, ...) \
-      MEGATECH_ASSERT_MSG_FORMAT(exp, msg __VA_OPT__(,) __VA_ARGS__)
-    #define MEGATECH_POSTCONDITION_MSG_FORMAT(exp, msg, ...) \
-      MEGATECH_ASSERT_MSG_FORMAT(exp, msg __VA_OPT__(,) __VA_ARGS__)
+#else
+  #ifndef MEGATECH_ASSERTIONS_FORMAT_UNAVAILABLE
+    #define MEGATECH_ASSERTIONS_FORMAT_UNAVAILABLE (1)
   #endif
-  #if defined(MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_PRINTF)
-    #define MEGATECH_ASSERT_MSG(exp, msg, ...) MEGATECH_ASSERT_MSG_PRINTF(exp, msg __VA_OPT__(,) __VA_ARGS__)
-  #elif defined(MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT)
-    #define MEGATECH_ASSERT_MSG(exp, msg, ...) MEGATECH_ASSERT_MSG_FORMAT(exp, msg __VA_OPT__(,) __VA_ARGS__)
+  #ifdef MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT
+    #error "<format> based assertions are not available."
   #endif
-  #define MEGATECH_ASSERT(exp) (megatech::debug_assertion(std::source_location::current(), (exp), (#exp)))
-  #define MEGATECH_PRECONDITION_MSG(exp, msg, ...) MEGATECH_ASSERT_MSG(exp, msg __VA_OPT__(,) __VA_ARGS__)
-  #define MEGATECH_PRECONDITION(exp) MEGATECH_ASSERT(exp)
-  #define MEGATECH_POSTCONDITION_MSG(exp, msg, ...) MEGATECH_ASSERT_MSG(exp, msg __VA_OPT__(,) __VA_ARGS__)
-  #define MEGATECH_POSTCONDITION(exp) MEGATECH_ASSERT(exp)
-#else
-  #define MEGATECH_ASSERT(exp) ((void) 0)
-  #define MEGATECH_ASSERT_MSG(exp, msg, ...) ((void) 0)
-  #define MEGATECH_ASSERT_MSG_PRINTF(exp, msg, ...) ((void) 0)
-  #define MEGATECH_PRECONDITION(exp) ((void) 0)
-  #define MEGATECH_PRECONDITION_MSG(exp, msg, ...) ((void) 0)
-  #define MEGATECH_PRECONDITION_MSG_PRINTF(exp, msg, ...) ((void) 0)
-  #define MEGATECH_POSTCONDITION(exp) ((void) 0)
-  #define MEGATECH_POSTCONDITION_MSG(exp, msg, ...) ((void) 0)
-  #define MEGATECH_POSTCONDITION_MSG_PRINTF(exp, msg, ...) ((void) 0)
-  #if MEGATECH_ASSERTIONS_FORMAT_AVAILABLE
-    #define MEGATECH_ASSERT_MSG_FORMAT(exp, msg, ...) ((void) 0)
-    #define MEGATECH_PRECONDITION_MSG_FORMAT(exp, msg, ...) ((void) 0)
-    #define MEGATECH_POSTCONDITION_MSG_FORMAT(exp, msg, ...) ((void) 0)
+  #ifdef MEGATECH_ASSERTIONS_DEFERRED_FORMAT
+    #error "Deferred formatting requires <format> based assertions."
   #endif
 #endif
-
-#define MEGATECH_ASSERTIONS_AVAILABLE (1)
 /// @endcond
 
-/// @cond INTERNAL
-namespace megatech::internal::base {
-
-  /**
-   * @brief Emit a diagnostic message containing the failing expression and abort the program.
-   * @details This function is thread-safe. This means that when an assertion failure occurs on a second thread, while
-   *          processing an assertion on the initial thread, both assertion messages will be collected and output
-   *          before aborting the program.
-   * @param location The location at which the program failed.
-   * @param expression A textual representation of the assertion's expression. This can be `nullptr`. If it is not
-   *        `nullptr`, it must be a NUL-terminated string.
-   */
-  [[noreturn]]
-  void dispatch_assertion_failure(const std::source_location& location, const char* expression) noexcept;
-
-  /**
-   * @brief Emit a diagnostic message containing the failing expression and abort the program.
-   * @details This function is thread-safe. This means that when an assertion failure occurs on a second thread, while
-   *          processing an assertion on the initial thread, both assertion messages will be collected and output
-   *          before aborting the program.
-   * @param location The location at which the program failed.
-   * @param expression A textual representation of the assertion's expression. This can be `nullptr`. If it is not
-   *        `nullptr`, it must be a NUL-terminated string.
-   * @param message A message to output explaining the assertion failure. This can be `nullptr`. If it is not
-   *                `nullptr`, it must be a NUL-terminated string.
-   */
-  [[noreturn]]
-  void dispatch_assertion_failure_with_message(const std::source_location& location, const char* expression,
-                                               const char* message) noexcept;
-
-  /**
-   * @brief Attempt to recover from an error during an assertion failure.
-   * @details This is called whenever an error occurs while processing a failed assertion. Some errors are probably
-   *          unrecoverable, but this still attempts to write as much information as it can to standard error. This
-   *          function is not thread-safe. That means that it will not attempt to collect assertion failures occurring
-   *          in parallel. Instead, it simply writes to standard error and immediately aborts the program.
-   * @param location The location at which the program failed.
-   * @param expression A textual representation of the assertion's expression. This can be `nullptr`. If it is not
-   *        `nullptr`, it must be a NUL-terminated string.
-   * @param error An error message explaining what kind of error occurred. This can be `nullptr`. If it is not
-   *             `nullptr`, it must be a NUL-terminated string.
-   */
-  [[noreturn]]
-  void dispatch_assertion_failure_with_error(const std::source_location& location, const char* expression,
-                                             const char* error) noexcept;
-
-#ifdef MEGATECH_ASSERTIONS_FORMAT_AVAILABLE
-  /**
-   * @brief Internal handler for "format"-style assertions.
-   * @param location The location at which the assertion is found.
-   * @param condition Whether or not the assertion passed. If this is false the program will be aborted with a
-   *                  diagnostic.
-   * @param expression A textual representation of the assertion's expression.
-   * @param format The format of the diagnostic message associated with the assertion.
-   * @param args A type-erased collection of format arguments.
-   */
-  void debug_assertion_format(const std::source_location& location, const bool condition, const char *const expression,
-                              const std::string_view& format, std::format_args&& args) noexcept;
-#endif
+#include <megatech/assertions/slim.hpp>
 
-}
-/// @endcond
-
-namespace megatech {
-
-  /**
-   * @brief Process an assertion without a formatted message.
-   * @details This is the safest assetion function. It has minimal potential for failure even if a thoroughly broken
-   *          program.
-   * @param location The location at which the assertion is found.
-   * @param condition Whether or not the assertion passed. If this is false the program will be aborted with a
-   *                  diagnostic.
-   * @param expression A textual representation of the assertion's expression.
-   */
-  void debug_assertion(const std::source_location& location, const bool condition,
-                       const char *const expression) noexcept;
-
-  /**
-   * @brief Process an assertion using the "printf"-style formatting syntax.
-   * @param location The location at which the assertion is found.
-   * @param condition Whether or not the assertion passed. If this is false the program will be aborted with a
-   *                  diagnostic.
-   * @param expression A textual representation of the assertion's expression.
-   * @param format The format of the diagnostic message associated with the assertion.
-   * @param ... 0 or more formatting arguments to use when rendering the diagnostic message.
-   */
-  void debug_assertion_printf(const std::source_location& location, const bool condition,
-                              const char *const expression, const char *const format, ...) noexcept;
-
-#ifdef MEGATECH_ASSERTIONS_FORMAT_AVAILABLE
-  /**
-   * @brief Process an assertion using the "format"-style formatting syntax.
-   * @param location The location at which the assertion is found.
-   * @param condition Whether or not the assertion passed. If this is false the program will be aborted with a
-   *                  diagnostic.
-   * @param expression A textual representation of the assertion's expression.
-   * @param format The format of the diagnostic message associated with the assertion.
-   * @param args 0 or more formatting arguments to use when rendering the diagnostic message.
-   */
-  template <typename... Args>
-  void debug_assertion_format(const std::source_location& location, const bool condition, const char *const expression,
-                              const std::format_string<Args...>& format, Args&&... args) noexcept {
-    using internal::base::debug_assertion_format;
-    debug_assertion_format(location, condition, expression, format.get(), std::make_format_args(args...));
-  }
+#ifndef MEGATECH_ASSERTIONS_FORMAT_UNAVAILABLE
+  #include <megatech/assertions/format.hpp>
 #endif
 
-}
-
 #endif
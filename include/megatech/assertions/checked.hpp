@@ -0,0 +1,286 @@
+/**
+ * @file checked.hpp
+ * @brief Bounds Checked Access
+ * @details Checked access compiles to a single unsigned comparison and a branch to a shared out-of-line failure
+ *          function that reports the index and the size. When assertions are disabled, checked access is a raw
+ *          access. If ::MEGATECH_ASSERTIONS_ASSUME_CONTRACTS is also defined, the bounds are assumed instead.
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2024
+ */
+#ifndef MEGATECH_ASSERTIONS_CHECKED_HPP
+#define MEGATECH_ASSERTIONS_CHECKED_HPP
+
+#include <megatech/assertions.hpp>
+
+#include <cstddef>
+
+#include <iterator>
+#include <source_location>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+/// @cond INTERNAL
+namespace megatech::internal::base {
+
+  /**
+   * @brief Emit a diagnostic message describing an out of bounds access and abort the program.
+   * @details Every checked access shares this function, so the only code at each access is a comparison and a branch.
+   * @param index The index that was accessed.
+   * @param size The size of the accessed range.
+   * @param location The location of the access.
+   */
+  [[noreturn]] MEGATECH_ASSERTIONS_COLD
+  inline void dispatch_bounds_failure(const std::size_t index, const std::size_t size,
+                                      const std::source_location location) noexcept {
+    const auto site = assertion_site{ location.file_name(), location.line(), location.function_name(), "index < size",
+                                      "index %zu is out of bounds for size %zu" };
+    dispatch_assertion_failure_printf(&site, index, size);
+  }
+
+  /**
+   * @brief Check that an index is inside of a range.
+   * @param index The index to check.
+   * @param size The size of the range.
+   * @param location The location of the access.
+   */
+  MEGATECH_ASSERTIONS_INLINE
+  constexpr void check_bounds([[maybe_unused]] const std::size_t index, [[maybe_unused]] const std::size_t size,
+                              [[maybe_unused]] const std::source_location location) noexcept {
+#if defined(MEGATECH_ASSERTIONS_ENABLED)
+    if (std::is_constant_evaluated())
+    {
+      constant_evaluated_assertion(index < size, "index < size");
+    }
+    else if (index >= size) [[unlikely]]
+    {
+      dispatch_bounds_failure(index, size, location);
+    }
+#elif defined(MEGATECH_ASSERTIONS_ASSUME_CONTRACTS)
+    MEGATECH_ASSERTIONS_ASSUME_HINT(index < size);
+#endif
+  }
+
+  /**
+   * @brief The type of a `std::span` constructed from a range.
+   * @tparam Range The type of the range.
+   */
+  template <typename Range>
+  using span_for_t = decltype(std::span{ std::declval<Range&>() });
+
+}
+/// @endcond
+
+namespace megatech {
+
+  /**
+   * @brief An index along with the location where it was written.
+   * @details This is implicitly constructible from `std::size_t`, so the location of a subscript expression can be
+   *          captured even though `operator[]` only accepts a single argument.
+   */
+  struct checked_index final {
+    /**
+     * @brief The value of the index.
+     */
+    std::size_t value{ };
+
+    /**
+     * @brief The location of the access.
+     */
+    std::source_location location{ };
+
+    /**
+     * @brief Construct a checked_index.
+     * @param value The value of the index.
+     * @param location The location of the access. By default, this is the location of the expression that converted
+     *                 the index.
+     */
+    constexpr checked_index(const std::size_t value,
+                            const std::source_location location = std::source_location::current()) noexcept :
+    value{ value }, location{ location } { }
+  };
+
+  /**
+   * @brief Access an element of a container after checking that its index is in bounds.
+   * @details When the index is out of bounds, the index and the size of the container are reported along with the
+   *          location of the call.
+   * @tparam Container The type of the container. `std::size(container)` and `container[index]` **MUST** both be
+   *                   well-formed.
+   * @param container The container to access.
+   * @param index The index of the element to access.
+   * @param location The location of the access. By default, this is the location of the call.
+   * @return The result of `container[index]`.
+   */
+  template <typename Container>
+  requires requires (Container&& container, const std::size_t index) {
+    std::size(container);
+    std::forward<Container>(container)[index];
+  }
+  MEGATECH_ASSERTIONS_INLINE
+  constexpr decltype(auto) checked_at(Container&& container, const std::size_t index,
+                                      const std::source_location location = std::source_location::current()) noexcept {
+    internal::base::check_bounds(index, static_cast<std::size_t>(std::size(container)), location);
+    return std::forward<Container>(container)[index];
+  }
+
+  /**
+   * @brief A `std::span` whose element accesses are checked.
+   * @details Only accessing an element is checked. Iteration and the underlying data pointer are unchecked. To create
+   *          a subspan, convert to a `std::span` with span(), and construct a new checked_span from the result.
+   * @tparam Type The type of the elements.
+   * @tparam Extent The number of elements or `std::dynamic_extent`.
+   */
+  template <typename Type, std::size_t Extent = std::dynamic_extent>
+  class checked_span final {
+  private:
+    std::span<Type, Extent> m_span{ };
+  public:
+    using element_type = typename std::span<Type, Extent>::element_type;
+    using value_type = typename std::span<Type, Extent>::value_type;
+    using size_type = typename std::span<Type, Extent>::size_type;
+    using difference_type = typename std::span<Type, Extent>::difference_type;
+    using pointer = typename std::span<Type, Extent>::pointer;
+    using const_pointer = typename std::span<Type, Extent>::const_pointer;
+    using reference = typename std::span<Type, Extent>::reference;
+    using const_reference = typename std::span<Type, Extent>::const_reference;
+    using iterator = typename std::span<Type, Extent>::iterator;
+
+    /**
+     * @brief The number of elements or `std::dynamic_extent`.
+     */
+    static constexpr std::size_t extent = Extent;
+
+    /**
+     * @brief Construct an empty checked_span.
+     */
+    constexpr checked_span() noexcept = default;
+
+    /**
+     * @brief Construct a checked_span from anything that can construct a `std::span`.
+     * @details This is explicit whenever the equivalent `std::span` conversion is explicit.
+     * @tparam Range The type of the range.
+     * @param range The range to view.
+     */
+    template <typename Range>
+    requires (!std::is_same_v<std::remove_cvref_t<Range>, checked_span> &&
+              std::is_constructible_v<std::span<Type, Extent>, Range>)
+    constexpr explicit(!std::is_convertible_v<Range, std::span<Type, Extent>>) checked_span(Range&& range) noexcept :
+    m_span(std::forward<Range>(range)) { }
+
+    /**
+     * @brief Construct a checked_span from a pointer and a number of elements.
+     * @param data A pointer to the first element.
+     * @param count The number of elements.
+     */
+    constexpr explicit(Extent != std::dynamic_extent) checked_span(const pointer data, const size_type count) noexcept :
+    m_span{ data, count } { }
+
+    /**
+     * @brief Retrieve the number of elements.
+     * @return The number of elements.
+     */
+    constexpr size_type size() const noexcept {
+      return m_span.size();
+    }
+
+    /**
+     * @brief Retrieve the size of the viewed elements in bytes.
+     * @return The size of the viewed elements in bytes.
+     */
+    constexpr size_type size_bytes() const noexcept {
+      return m_span.size_bytes();
+    }
+
+    /**
+     * @brief Determine whether or not there are any elements.
+     * @return True if there are no elements. False otherwise.
+     */
+    [[nodiscard]] constexpr bool empty() const noexcept {
+      return m_span.empty();
+    }
+
+    /**
+     * @brief Retrieve a pointer to the first element.
+     * @return A pointer to the first element.
+     */
+    constexpr pointer data() const noexcept {
+      return m_span.data();
+    }
+
+    /**
+     * @brief Retrieve an iterator to the first element.
+     * @return An iterator to the first element.
+     */
+    constexpr iterator begin() const noexcept {
+      return m_span.begin();
+    }
+
+    /**
+     * @brief Retrieve an iterator past the last element.
+     * @return An iterator past the last element.
+     */
+    constexpr iterator end() const noexcept {
+      return m_span.end();
+    }
+
+    /**
+     * @brief Retrieve the unchecked view.
+     * @return The underlying `std::span`.
+     */
+    constexpr std::span<Type, Extent> span() const noexcept {
+      return m_span;
+    }
+
+    /**
+     * @brief Convert to an unchecked view.
+     * @return The underlying `std::span`.
+     */
+    constexpr operator std::span<Type, Extent>() const noexcept {
+      return m_span;
+    }
+
+    /**
+     * @brief Access an element after checking that its index is in bounds.
+     * @param index The index of the element to access.
+     * @return A reference to the element.
+     */
+    MEGATECH_ASSERTIONS_INLINE
+    constexpr reference operator[](const checked_index index) const noexcept {
+      internal::base::check_bounds(index.value, m_span.size(), index.location);
+      return m_span[index.value];
+    }
+
+    /**
+     * @brief Access the first element after checking that there is one.
+     * @param location The location of the access. By default, this is the location of the call.
+     * @return A reference to the first element.
+     */
+    MEGATECH_ASSERTIONS_INLINE
+    constexpr reference front(const std::source_location location = std::source_location::current()) const noexcept {
+      internal::base::check_bounds(0, m_span.size(), location);
+      return m_span.front();
+    }
+
+    /**
+     * @brief Access the last element after checking that there is one.
+     * @param location The location of the access. By default, this is the location of the call.
+     * @return A reference to the last element.
+     */
+    MEGATECH_ASSERTIONS_INLINE
+    constexpr reference back(const std::source_location location = std::source_location::current()) const noexcept {
+      internal::base::check_bounds(0, m_span.size(), location);
+      return m_span.back();
+    }
+  };
+
+  template <typename Range>
+  checked_span(Range&&) -> checked_span<typename internal::base::span_for_t<Range>::element_type,
+                                        internal::base::span_for_t<Range>::extent>;
+
+  template <typename Type>
+  checked_span(Type*, std::size_t) -> checked_span<Type>;
+
+}
+
+#endif
@@ -0,0 +1,373 @@
+/**
+ * @file format.hpp
+ * @brief "format"-Style Run-Time Assertions
+ * @details This adds the "format"-style assertions (e.g., ::MEGATECH_ASSERT_MSG_FORMAT and ::MEGATECH_ASSERT_CONTEXT)
+ *          to `megatech/assertions/slim.hpp`. It is the only assertion header that includes `<format>`. Comparisons
+ *          that are expanded after this is included render their operands with the "format"-style syntax when
+ *          possible. `megatech/assertions.hpp` includes this automatically whenever `<format>` is available.
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2024
+ */
+#ifndef MEGATECH_ASSERTIONS_FORMAT_HPP
+#define MEGATECH_ASSERTIONS_FORMAT_HPP
+
+#if !__has_include(<format>) || defined(MEGATECH_ASSERTIONS_FORMAT_UNAVAILABLE)
+  #error "<format> based assertions are not available."
+#endif
+
+/// @cond
+#ifndef MEGATECH_ASSERTIONS_FORMAT_AVAILABLE
+  #define MEGATECH_ASSERTIONS_FORMAT_AVAILABLE (1)
+#endif
+/// @endcond
+
+#include <megatech/assertions/slim.hpp>
+// The "format" macros are in their own section of macros.hpp. Including it again processes that section even when
+// slim.hpp was included first.
+#include <megatech/assertions/macros.hpp>
+
+#include <cstddef>
+#include <cstring>
+
+#include <array>
+#include <format>
+#include <string_view>
+#include <type_traits>
+
+/// @cond INTERNAL
+namespace megatech::internal::base {
+
+  /**
+   * @brief Render a "format"-style diagnostic message, emit it along with the failing expression, and abort the
+   *        program.
+   * @param site The site of the failing assertion. The site's format is used to render the diagnostic message.
+   * @param args A type-erased collection of format arguments.
+   */
+  [[noreturn]] MEGATECH_ASSERTIONS_COLD
+  void dispatch_assertion_failure_format(const assertion_site& site, std::format_args&& args) noexcept;
+
+  /**
+   * @brief Count a soft assertion failure and emit a "format"-style diagnostic message.
+   * @param site The site of the failing soft assertion. The site's format is used to render the diagnostic message.
+   * @param args A type-erased collection of format arguments.
+   * @see dispatch_soft_assertion_failure()
+   */
+  MEGATECH_ASSERTIONS_COLD
+  void dispatch_soft_assertion_failure_format(const assertion_site& site, std::format_args&& args) noexcept;
+
+  /**
+   * @brief The maximum number of arguments that a deferred "format"-style assertion may have.
+   */
+  constexpr std::size_t deferred_argument_limit{ 16 };
+
+  /**
+   * @brief Type tags describing each argument in a deferred argument encoding.
+   */
+  enum class deferred_argument_type : unsigned char {
+    boolean,
+    character,
+    signed_integer,
+    unsigned_integer,
+    single_floating_point,
+    floating_point,
+    long_floating_point,
+    string,
+    string_view,
+    pointer
+  };
+
+  /**
+   * @brief Determine how a deferred argument of a given type is encoded.
+   * @tparam Type The type of the argument.
+   * @return The argument's type tag.
+   */
+  template <typename Type>
+  consteval deferred_argument_type deferred_argument_type_of() noexcept {
+    using value_type = std::decay_t<Type>;
+    if constexpr (std::is_same_v<value_type, bool>)
+    {
+      return deferred_argument_type::boolean;
+    }
+    else if constexpr (std::is_same_v<value_type, char>)
+    {
+      return deferred_argument_type::character;
+    }
+    else if constexpr (std::is_integral_v<value_type> && std::is_signed_v<value_type>)
+    {
+      return deferred_argument_type::signed_integer;
+    }
+    else if constexpr (std::is_integral_v<value_type>)
+    {
+      return deferred_argument_type::unsigned_integer;
+    }
+    else if constexpr (std::is_same_v<value_type, float>)
+    {
+      // float isn't widened, since it would otherwise be formatted with double precision.
+      return deferred_argument_type::single_floating_point;
+    }
+    else if constexpr (std::is_same_v<value_type, long double>)
+    {
+      return deferred_argument_type::long_floating_point;
+    }
+    else if constexpr (std::is_floating_point_v<value_type>)
+    {
+      return deferred_argument_type::floating_point;
+    }
+    else if constexpr (std::is_same_v<value_type, const char*> || std::is_same_v<value_type, char*>)
+    {
+      return deferred_argument_type::string;
+    }
+    else if constexpr (std::is_same_v<value_type, std::string_view>)
+    {
+      return deferred_argument_type::string_view;
+    }
+    else
+    {
+      static_assert(std::is_pointer_v<value_type> || std::is_null_pointer_v<value_type>,
+                    "Deferred formatting only supports bool, character, integer, floating point, string, and pointer "
+                    "arguments.");
+      return deferred_argument_type::pointer;
+    }
+  }
+
+  /**
+   * @brief The payload type that a deferred argument of a given type is widened to.
+   * @tparam Tag The argument's type tag.
+   */
+  template <deferred_argument_type Tag>
+  using deferred_payload_t = std::conditional_t<Tag == deferred_argument_type::boolean, bool,
+                             std::conditional_t<Tag == deferred_argument_type::character, char,
+                             std::conditional_t<Tag == deferred_argument_type::signed_integer, long long,
+                             std::conditional_t<Tag == deferred_argument_type::unsigned_integer, unsigned long long,
+                             std::conditional_t<Tag == deferred_argument_type::single_floating_point, float,
+                             std::conditional_t<Tag == deferred_argument_type::floating_point, double,
+                             std::conditional_t<Tag == deferred_argument_type::long_floating_point, long double,
+                             std::conditional_t<Tag == deferred_argument_type::string, const char*,
+                             std::conditional_t<Tag == deferred_argument_type::string_view, std::string_view,
+                                                const void*>>>>>>>>>;
+
+  /**
+   * @brief A compact, trivially copyable, encoding of "format"-style assertion arguments.
+   * @details Each argument is encoded as a one byte type tag followed by the raw bytes of its (widened) value. The
+   *          encoding is decoded and formatted by the library.
+   * @tparam Args The types of the encoded arguments.
+   */
+  template <typename... Args>
+  class deferred_arguments final {
+  private:
+    static_assert(sizeof...(Args) <= deferred_argument_limit, "Too many arguments for deferred formatting.");
+
+    std::array<std::byte, (0 + ... + (1 + sizeof(deferred_payload_t<deferred_argument_type_of<Args>()>)))> m_data{ };
+
+    template <typename Type>
+    std::byte* encode(std::byte* position, const Type& arg) noexcept {
+      constexpr auto tag = deferred_argument_type_of<Type>();
+      const auto payload = static_cast<deferred_payload_t<tag>>(arg);
+      *position++ = static_cast<std::byte>(tag);
+      std::memcpy(position, &payload, sizeof(payload));
+      return position + sizeof(payload);
+    }
+  public:
+    /**
+     * @brief Encode a set of arguments.
+     * @param args 0 or more arguments to encode.
+     */
+    explicit deferred_arguments(const Args&... args) noexcept {
+      [[maybe_unused]] auto position = m_data.data();
+      ((position = encode(position, args)), ...);
+    }
+
+    /**
+     * @brief Retrieve the encoded bytes.
+     * @return A pointer to the encoded bytes.
+     */
+    const std::byte* data() const noexcept {
+      return m_data.data();
+    }
+
+    /**
+     * @brief Retrieve the size of the encoding.
+     * @return The number of encoded bytes.
+     */
+    std::size_t size() const noexcept {
+      return m_data.size();
+    }
+  };
+
+  /**
+   * @brief Decode and render a deferred "format"-style diagnostic message, emit it along with the failing expression,
+   *        and abort the program.
+   * @param site The site of the failing assertion. The site's format is used to render the diagnostic message.
+   * @param arguments A pointer to a deferred argument encoding.
+   * @param size The size of the encoding in bytes.
+   * @see megatech::internal::base::deferred_arguments
+   */
+  [[noreturn]] MEGATECH_ASSERTIONS_COLD
+  void dispatch_assertion_failure_deferred(const assertion_site& site, const std::byte* arguments,
+                                           const std::size_t size) noexcept;
+
+  /**
+   * @brief Count a soft assertion failure and emit a deferred "format"-style diagnostic message.
+   * @param site The site of the failing soft assertion. The site's format is used to render the diagnostic message.
+   * @param arguments A pointer to a deferred argument encoding.
+   * @param size The size of the encoding in bytes.
+   * @see dispatch_soft_assertion_failure()
+   */
+  MEGATECH_ASSERTIONS_COLD
+  void dispatch_soft_assertion_failure_deferred(const assertion_site& site, const std::byte* arguments,
+                                                const std::size_t size) noexcept;
+
+  /**
+   * @brief Determine whether a value of a given type can be deferred.
+   * @tparam Type The type of the value.
+   */
+  template <typename Type>
+  concept deferred_argument = std::is_arithmetic_v<std::decay_t<Type>> || std::is_pointer_v<std::decay_t<Type>> ||
+                              std::is_null_pointer_v<std::decay_t<Type>> ||
+                              std::is_same_v<std::decay_t<Type>, std::string_view>;
+
+  /**
+   * @brief A scope created with ::MEGATECH_ASSERT_CONTEXT.
+   * @details The scope is pushed onto the calling thread's context stack when it's created and popped when it's
+   *          destroyed. It can't be copied or moved, since the stack refers to it.
+   * @tparam Args The types of the description's arguments.
+   */
+  template <typename... Args>
+  class assertion_context_scope final {
+  private:
+    deferred_arguments<Args...> m_arguments;
+    assertion_context m_context;
+  public:
+    /**
+     * @brief Push a new scope.
+     * @param format The description's format.
+     * @param args 0 or more arguments to copy.
+     */
+    explicit assertion_context_scope(const std::string_view format, const Args&... args) noexcept :
+    m_arguments{ args... }, m_context{ format, m_arguments.data(), m_arguments.size() } {
+      auto& contexts = pt_assertion_contexts;
+      if (contexts.depth < contexts.entries.size())
+      {
+        contexts.entries[contexts.depth] = &m_context;
+      }
+      ++contexts.depth;
+    }
+    assertion_context_scope(const assertion_context_scope& other) = delete;
+    assertion_context_scope(assertion_context_scope&& other) = delete;
+
+    /**
+     * @brief Pop the scope.
+     */
+    ~assertion_context_scope() noexcept {
+      --pt_assertion_contexts.depth;
+    }
+
+    assertion_context_scope& operator=(const assertion_context_scope& rhs) = delete;
+    assertion_context_scope& operator=(assertion_context_scope&& rhs) = delete;
+  };
+
+  /**
+   * @brief Create a context scope. The format is checked at compile-time.
+   * @tparam Args The types of the description's arguments. Every type **MUST** satisfy deferred_argument.
+   * @param format The description's format.
+   * @param args 0 or more arguments to copy.
+   * @return The new scope.
+   */
+  template <typename... Args>
+  requires (deferred_argument<Args> && ...)
+  assertion_context_scope<std::remove_cvref_t<Args>...> make_assertion_context(const std::format_string<Args...> format,
+                                                                               Args&&... args) noexcept {
+    return assertion_context_scope<std::remove_cvref_t<Args>...>{ format.get(), args... };
+  }
+
+  /**
+   * @brief Determine whether both operands of a failing comparison are rendered with the "format"-style syntax.
+   * @details With ::MEGATECH_ASSERTIONS_DEFERRED_FORMAT defined, this requires that both operands can be deferred.
+   *          Otherwise, it requires a `std::formatter` for both operands.
+   * @tparam Left The type of the left operand.
+   * @tparam Right The type of the right operand.
+   */
+  template <typename Left, typename Right>
+  constexpr bool format_comparison_v<true, Left, Right> =
+#ifdef MEGATECH_ASSERTIONS_DEFERRED_FORMAT
+    deferred_argument<Left> && deferred_argument<Right>;
+#else
+    std::is_default_constructible_v<std::formatter<std::remove_cvref_t<Left>, char>> &&
+    std::is_default_constructible_v<std::formatter<std::remove_cvref_t<Right>, char>>;
+#endif
+
+  template <typename Left, typename Right>
+  [[noreturn]] MEGATECH_ASSERTIONS_COLD
+  void dispatch_comparison_failure_format(const assertion_site& site, const comparison_operand_t<Left> left,
+                                          const comparison_operand_t<Right> right) noexcept {
+#ifdef MEGATECH_ASSERTIONS_DEFERRED_FORMAT
+    const auto arguments = deferred_arguments<Left, Right>{ left, right };
+    dispatch_assertion_failure_deferred(site, arguments.data(), arguments.size());
+#else
+    dispatch_assertion_failure_format(site, std::make_format_args(left, right));
+#endif
+  }
+
+}
+/// @endcond
+
+namespace megatech {
+
+  /**
+   * @brief Process an assertion using the "format"-style formatting syntax.
+   * @details The condition is tested inline. The arguments are only captured, and type-erased, after the condition
+   *          has failed. Until then, they're held by reference.
+   * @tparam Args The types of the formatting arguments.
+   * @param site The site of the assertion.
+   * @param condition Whether or not the assertion passed. If this is false the program will be aborted with a
+   *                  diagnostic.
+   * @param format The format of the diagnostic message associated with the assertion. This is only used to check the
+   *               arguments at compile-time and it **MUST** be the same as the site's format.
+   * @param args 0 or more formatting arguments to use when rendering the diagnostic message.
+   */
+  template <typename... Args>
+  MEGATECH_ASSERTIONS_INLINE
+  void debug_assertion_format(const assertion_site& site, const bool condition,
+                              const std::format_string<Args...>& format, Args&&... args) noexcept {
+    (void) format;
+    if (!condition) [[unlikely]]
+    {
+#ifdef MEGATECH_ASSERTIONS_DEFERRED_FORMAT
+      const auto arguments = internal::base::deferred_arguments<std::remove_cvref_t<Args>...>{ args... };
+      internal::base::dispatch_assertion_failure_deferred(site, arguments.data(), arguments.size());
+#else
+      internal::base::dispatch_assertion_failure_format(site, std::make_format_args(args...));
+#endif
+    }
+  }
+
+  /**
+   * @brief Process a soft assertion using the "format"-style formatting syntax.
+   * @tparam Args The types of the formatting arguments.
+   * @param site The site of the soft assertion. The site **MUST** have a counter.
+   * @param condition Whether or not the assertion passed. If this is false the failure is counted.
+   * @param format The format of the diagnostic message associated with the assertion. This is only used to check the
+   *               arguments at compile-time and it **MUST** be the same as the site's format.
+   * @param args 0 or more formatting arguments to use when rendering the diagnostic message.
+   * @see megatech::soft_assertion()
+   */
+  template <typename... Args>
+  MEGATECH_ASSERTIONS_INLINE
+  void soft_assertion_format(const assertion_site& site, const bool condition,
+                             const std::format_string<Args...>& format, Args&&... args) noexcept {
+    (void) format;
+    if (!condition) [[unlikely]]
+    {
+#ifdef MEGATECH_ASSERTIONS_DEFERRED_FORMAT
+      const auto arguments = internal::base::deferred_arguments<std::remove_cvref_t<Args>...>{ args... };
+      internal::base::dispatch_soft_assertion_failure_deferred(site, arguments.data(), arguments.size());
+#else
+      internal::base::dispatch_soft_assertion_failure_format(site, std::make_format_args(args...));
+#endif
+    }
+  }
+
+}
+
+#endif
@@ -0,0 +1,168 @@
+/**
+ * @file journal.hpp
+ * @brief Assertion Failure Journal
+ * @details The journal is an optional memory-mapped file that records every assertion failure in a fixed-size binary
+ *          format. Records are written with plain stores into shared memory, so they survive `abort()` (and most other
+ *          ways that a process can die) without any system call on the failure path. The
+ *          `megatech-assertions-journal` tool prints the records of a journal file.
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2024
+ */
+#ifndef MEGATECH_ASSERTIONS_JOURNAL_HPP
+#define MEGATECH_ASSERTIONS_JOURNAL_HPP
+
+#include <megatech/assertions.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+
+namespace megatech {
+
+  /**
+   * @brief The header at the beginning of a journal file.
+   * @details Every field is stored in the byte order of the process that created the journal.
+   */
+  struct alignas(64) assertion_journal_header final {
+    /**
+     * @brief The magic number identifying a journal file.
+     */
+    static constexpr std::array<char, 8> magic_value{ 'M', 'T', 'A', 'S', 'J', 'R', 'N', 'L' };
+
+    /**
+     * @brief The current version of the journal format.
+     */
+    static constexpr std::uint32_t current_version = 1;
+
+    /**
+     * @brief The magic number. This is always magic_value.
+     */
+    std::array<char, 8> magic{ };
+
+    /**
+     * @brief The version of the journal format.
+     */
+    std::uint32_t version{ };
+
+    /**
+     * @brief The size of each record in bytes.
+     */
+    std::uint32_t record_size{ };
+
+    /**
+     * @brief The number of records in the journal.
+     */
+    std::uint64_t capacity{ };
+
+    /**
+     * @brief The number of records that have ever been claimed. Records are claimed in a ring, so once this exceeds
+     *        the capacity, the oldest records are overwritten.
+     */
+    std::uint64_t claimed{ };
+  };
+
+  /**
+   * @brief A single journaled assertion failure.
+   * @details Strings are NUL-terminated and truncated to fit. A record is complete only when its sequence number is not
+   *          0. The sequence number is cleared before a record is overwritten and is written last.
+   */
+  struct assertion_journal_record final {
+    /**
+     * @brief The flag indicating that the failing assertion was a soft assertion.
+     */
+    static constexpr std::uint32_t soft_flag = 1;
+
+    /**
+     * @brief The flag indicating that the message describes an error during failure processing.
+     */
+    static constexpr std::uint32_t error_flag = 2;
+
+    /**
+     * @brief The sequence number of the failure, starting at 1. This is 0 if the record is empty or incomplete.
+     */
+    std::uint64_t sequence{ };
+
+    /**
+     * @brief An identifier for the failing thread. On POSIX systems, this is the value of `pthread_self()`.
+     */
+    std::uint64_t thread{ };
+
+    /**
+     * @brief The time of the failure in nanoseconds since the Unix epoch.
+     */
+    std::int64_t timestamp{ };
+
+    /**
+     * @brief The line number of the failing assertion.
+     */
+    std::uint32_t line{ };
+
+    /**
+     * @brief The ID of the failing assertion's site. This is 0 unless the site is compact.
+     */
+    std::uint32_t id{ };
+
+    /**
+     * @brief A combination of soft_flag and error_flag.
+     */
+    std::uint32_t flags{ };
+
+    std::uint32_t reserved{ };
+
+    /**
+     * @brief The name of the file containing the failing assertion.
+     */
+    std::array<char, 216> file_name{ };
+
+    /**
+     * @brief The name of the function containing the failing assertion.
+     */
+    std::array<char, 256> function_name{ };
+
+    /**
+     * @brief The failing assertion's expression.
+     */
+    std::array<char, 256> expression{ };
+
+    /**
+     * @brief The rendered diagnostic message, or an error if error_flag is set.
+     */
+    std::array<char, 256> message{ };
+  };
+
+  static_assert(sizeof(assertion_journal_header) == 64);
+  static_assert(sizeof(assertion_journal_record) == 1024);
+
+  /**
+   * @brief Begin journaling assertion failures to a file.
+   * @details If the file already contains a journal with the same capacity, new records are appended to it.
+   *          Otherwise, a new, empty, journal is created. Opening a journal replaces any previously opened journal.
+   *          The previous mapping is never removed, since failing threads may still be writing to it. If the
+   *          `MEGATECH_ASSERTIONS_JOURNAL` environment variable names a file, a journal with a capacity of 64 records
+   *          is opened automatically during static initialization.
+   * @param path The path of the journal file. This **MUST** be a NUL-terminated string.
+   * @param capacity The number of records in the journal. This **MUST** be greater than 0.
+   * @return True if the journal was opened. False otherwise. This is always false if memory-mapped files aren't
+   *         supported.
+   */
+  bool open_assertion_journal(const char* path, const std::size_t capacity) noexcept;
+
+}
+
+/// @cond INTERNAL
+namespace megatech::internal::base {
+
+  /**
+   * @brief Record a failure in the current journal, if there is one.
+   * @details This never allocates or calls into the kernel, aside from reading the real-time clock (which is a vDSO
+   *          call on Linux). It is async-signal-safe.
+   * @param failure The failure to record.
+   */
+  void journal_assertion_failure(const assertion_failure& failure) noexcept;
+
+}
+/// @endcond
+
+#endif
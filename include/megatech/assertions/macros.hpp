@@ -0,0 +1,500 @@
+/**
+ * @file macros.hpp
+ * @brief Assertion Macros
+ * @details This file contains every assertion macro, and nothing else. It depends only on `<cstdint>`,
+ *          `<source_location>`, and `<type_traits>`. Every macro refers to declarations provided by
+ *          `megatech/assertions/slim.hpp` (or by the `megatech.assertions` module), so this file is never included
+ *          directly. Clients include `megatech/assertions.hpp`, `megatech/assertions/slim.hpp`, or
+ *          `megatech/assertions/module.hpp` instead.
+ *
+ *          The "format"-style macros are defined by a second section of this file. That section is processed
+ *          whenever this file is included with ::MEGATECH_ASSERTIONS_FORMAT_AVAILABLE defined, even if the rest of the
+ *          file has already been processed.
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2024
+ */
+#ifndef MEGATECH_ASSERTIONS_MACROS_HPP
+#define MEGATECH_ASSERTIONS_MACROS_HPP
+
+#include <cstdint>
+
+#include <source_location>
+#include <type_traits>
+
+/// @cond
+// Without <format>, or before it's included, the default formatter is "printf". The "format" default is only chosen
+// explicitly, either by a client or by megatech/assertions.hpp.
+#if !defined(MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_PRINTF) && !defined(MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT)
+  #define MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_PRINTF (1)
+#elif defined(MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_PRINTF) && defined(MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT)
+  #error "Only one formatter can be used as the default formatter."
+#endif
+
+#define MEGATECH_ASSERTIONS_LEVEL_OFF (0)
+#define MEGATECH_ASSERTIONS_LEVEL_DEFAULT (1)
+#define MEGATECH_ASSERTIONS_LEVEL_AUDIT (2)
+
+#ifdef MEGATECH_ASSERTIONS_LEVEL
+  #if MEGATECH_ASSERTIONS_LEVEL < MEGATECH_ASSERTIONS_LEVEL_OFF || \
+      MEGATECH_ASSERTIONS_LEVEL > MEGATECH_ASSERTIONS_LEVEL_AUDIT
+    #error "The assertion level must be MEGATECH_ASSERTIONS_LEVEL_OFF, DEFAULT, or AUDIT."
+  #elif MEGATECH_ASSERTIONS_LEVEL == MEGATECH_ASSERTIONS_LEVEL_OFF && defined(MEGATECH_ASSERTIONS_ENABLED)
+    #error "Assertions cannot be enabled when the assertion level is MEGATECH_ASSERTIONS_LEVEL_OFF."
+  #elif MEGATECH_ASSERTIONS_LEVEL > MEGATECH_ASSERTIONS_LEVEL_OFF && !defined(MEGATECH_ASSERTIONS_ENABLED)
+    #define MEGATECH_ASSERTIONS_ENABLED (1)
+  #endif
+#endif
+
+#ifndef MEGATECH_ASSERTIONS_ENABLED
+  #if !defined(MEGATECH_ASSERTIONS_DISABLED) && !defined(NDEBUG)
+    #define MEGATECH_ASSERTIONS_ENABLED (1)
+  #endif
+#endif
+
+#if defined(MEGATECH_ASSERTIONS_ENABLED) && defined(MEGATECH_ASSERTIONS_DISABLED)
+  #error "Assertions cannot be enabled and disabled at the same time."
+#endif
+
+#ifndef MEGATECH_ASSERTIONS_LEVEL
+  #ifdef MEGATECH_ASSERTIONS_ENABLED
+    #define MEGATECH_ASSERTIONS_LEVEL MEGATECH_ASSERTIONS_LEVEL_DEFAULT
+  #else
+    #define MEGATECH_ASSERTIONS_LEVEL MEGATECH_ASSERTIONS_LEVEL_OFF
+  #endif
+#endif
+
+#ifndef MEGATECH_ASSERTIONS_CATEGORIES
+  #define MEGATECH_ASSERTIONS_CATEGORIES (~0ULL)
+#endif
+// Site descriptors are static objects, one per macro expansion. Creating them inside of an expression requires GNU
+// statement expressions. Without them sites are temporaries created at the call site.
+#if defined(__GNUC__) && !defined(MEGATECH_ASSERTIONS_STATIC_SITES_UNAVAILABLE)
+  #define MEGATECH_ASSERTIONS_STATIC_SITES_AVAILABLE (1)
+#elif !defined(MEGATECH_ASSERTIONS_STATIC_SITES_UNAVAILABLE)
+  #define MEGATECH_ASSERTIONS_STATIC_SITES_UNAVAILABLE (1)
+#endif
+
+// Run-time toggles are stored in the static site. A temporary site can't remember anything between evaluations.
+#ifdef MEGATECH_ASSERTIONS_RUNTIME_TOGGLES
+  #ifndef MEGATECH_ASSERTIONS_STATIC_SITES_AVAILABLE
+    #error "Run-time assertion toggles require static assertion sites."
+  #endif
+  #define MEGATECH_ASSERTIONS_SITE_ENABLED(site) (megatech::internal::base::assertion_site_enabled(site))
+#else
+  #define MEGATECH_ASSERTIONS_SITE_ENABLED(site) (true)
+#endif
+
+// On ELF targets, static sites are placed in a dedicated section. The linker collects every site in a module into one
+// contiguous array without any run-time registration. Sites are explicitly aligned to their natural alignment because
+// some compilers over-align large objects, which would break the array layout.
+#if defined(MEGATECH_ASSERTIONS_STATIC_SITES_AVAILABLE) && defined(__ELF__)
+  #define MEGATECH_ASSERTIONS_SITE_REGISTRY_AVAILABLE (1)
+  #define MEGATECH_ASSERTIONS_SITE_DECL \
+    alignas(megatech::assertion_site) [[gnu::used, gnu::section("megatech_assertion_sites")]] static constexpr
+#else
+  #define MEGATECH_ASSERTIONS_SITE_DECL static constexpr
+#endif
+
+// Compact sites replace their strings with an ID. The strings are kept, along with the ID, in a separate section that
+// nothing reads at run-time. Each entry is explicitly aligned for the same reason that sites are.
+#ifdef MEGATECH_ASSERTIONS_COMPACT_SITES
+  #ifndef MEGATECH_ASSERTIONS_SITE_REGISTRY_AVAILABLE
+    #error "Compact assertion sites require static assertion sites and an ELF target."
+  #endif
+  #define MEGATECH_ASSERTIONS_SITE_SYMBOL(expression) \
+    constexpr auto megatech_assertions_id = \
+      megatech::internal::base::compact_site_id(megatech_assertions_file_name, megatech_assertions_line, \
+                                                megatech_assertions_function_name, (expression)); \
+    alignas(megatech::internal::base::compact_site_symbol_header) \
+    [[gnu::used, gnu::section("megatech_assertion_symbols")]] static constexpr auto megatech_assertions_symbol = \
+      megatech::internal::base::make_compact_site_symbol< \
+        megatech::internal::base::string_length(megatech_assertions_file_name) + 1, \
+        megatech::internal::base::string_length(megatech_assertions_function_name) + 1, sizeof(expression)>( \
+          megatech_assertions_id, megatech_assertions_line, megatech_assertions_file_name, \
+          megatech_assertions_function_name, (expression));
+  #define MEGATECH_ASSERTIONS_SITE_INIT(expression, msg, counter) \
+    megatech::assertion_site{ nullptr, megatech_assertions_line, nullptr, nullptr, (msg), (counter), { true }, \
+                              megatech_assertions_id }
+#else
+  #define MEGATECH_ASSERTIONS_SITE_SYMBOL(expression)
+  #define MEGATECH_ASSERTIONS_SITE_INIT(expression, msg, counter) \
+    megatech::assertion_site{ megatech_assertions_file_name, megatech_assertions_line, \
+                              megatech_assertions_function_name, (expression), (msg), (counter) }
+#endif
+
+// Each thread claims its own profile for a site the first time that it evaluates the site. Only that thread writes to
+// the profile, so counting an evaluation never touches a cache line shared with another thread.
+#ifdef MEGATECH_ASSERTIONS_PROFILING
+  #ifndef MEGATECH_ASSERTIONS_STATIC_SITES_AVAILABLE
+    #error "Assertion profiling requires static assertion sites."
+  #endif
+  #define MEGATECH_ASSERTIONS_PROFILE_BEGIN(site) \
+    auto& megatech_assertions_profile = *[](const megatech::assertion_site& megatech_assertions_profiled_site) \
+      noexcept -> megatech::assertion_profile* { \
+      static thread_local megatech::assertion_profile* megatech_assertions_profile = nullptr; \
+      if (!megatech_assertions_profile) \
+      { \
+        megatech_assertions_profile = \
+          megatech::internal::base::claim_assertion_profile(megatech_assertions_profiled_site); \
+      } \
+      return megatech_assertions_profile; \
+    }(site); \
+    const auto megatech_assertions_profile_start = \
+      megatech::internal::base::begin_assertion_profile(megatech_assertions_profile);
+  #define MEGATECH_ASSERTIONS_PROFILE_END \
+    megatech::internal::base::end_assertion_profile(megatech_assertions_profile, megatech_assertions_profile_start);
+#else
+  #define MEGATECH_ASSERTIONS_PROFILE_BEGIN(site)
+  #define MEGATECH_ASSERTIONS_PROFILE_END
+#endif
+
+#if defined(MEGATECH_ASSERTIONS_PROFILE_CYCLES) && !defined(MEGATECH_ASSERTIONS_PROFILING)
+  #error "Profiling cycles requires assertion profiling."
+#endif
+
+// During constant evaluation there is no site and no report. A failing assertion calls a non-constexpr function
+// instead, which turns it into a compile error.
+#ifdef MEGATECH_ASSERTIONS_STATIC_SITES_AVAILABLE
+  #define MEGATECH_ASSERTIONS_DISPATCH(function, exp, msg, ...) \
+    (__extension__ ({ \
+      if (std::is_constant_evaluated()) \
+      { \
+        megatech::internal::base::constant_evaluated_assertion(static_cast<bool>(exp), (#exp)); \
+      } \
+      else \
+      { \
+        constexpr const char* megatech_assertions_file_name = std::source_location::current().file_name(); \
+        constexpr std::uint_least32_t megatech_assertions_line = std::source_location::current().line(); \
+        constexpr const char* megatech_assertions_function_name = std::source_location::current().function_name(); \
+        const auto& megatech_assertions_site_ref = *[]() noexcept -> const megatech::assertion_site* { \
+          MEGATECH_ASSERTIONS_SITE_SYMBOL(#exp) \
+          MEGATECH_ASSERTIONS_SITE_DECL auto megatech_assertions_site = \
+            MEGATECH_ASSERTIONS_SITE_INIT(#exp, msg, nullptr); \
+          return &megatech_assertions_site; \
+        }(); \
+        if (MEGATECH_ASSERTIONS_SITE_ENABLED(megatech_assertions_site_ref)) \
+        { \
+          MEGATECH_ASSERTIONS_PROFILE_BEGIN(megatech_assertions_site_ref) \
+          function(megatech_assertions_site_ref, static_cast<bool>(exp) __VA_OPT__(,) __VA_ARGS__); \
+          MEGATECH_ASSERTIONS_PROFILE_END \
+        } \
+      } \
+    }))
+#else
+  #define MEGATECH_ASSERTIONS_DISPATCH(function, exp, msg, ...) \
+    (std::is_constant_evaluated() ? \
+     megatech::internal::base::constant_evaluated_assertion(static_cast<bool>(exp), (#exp)) : \
+     function(megatech::assertion_site{ std::source_location::current().file_name(), \
+                                        std::source_location::current().line(), \
+                                        std::source_location::current().function_name(), (#exp), (msg) }, \
+              static_cast<bool>(exp) __VA_OPT__(,) __VA_ARGS__))
+#endif
+
+// Soft assertion sites also refer to a failure counter. Counters are separate, cache-line aligned, objects so that
+// registered sites stay densely packed and so that failures on different sites never contend.
+#ifdef MEGATECH_ASSERTIONS_STATIC_SITES_AVAILABLE
+  #define MEGATECH_ASSERTIONS_SOFT_DISPATCH(function, exp, msg, ...) \
+    (__extension__ ({ \
+      if (std::is_constant_evaluated()) \
+      { \
+        megatech::internal::base::constant_evaluated_assertion(static_cast<bool>(exp), (#exp)); \
+      } \
+      else \
+      { \
+        constexpr const char* megatech_assertions_file_name = std::source_location::current().file_name(); \
+        constexpr std::uint_least32_t megatech_assertions_line = std::source_location::current().line(); \
+        constexpr const char* megatech_assertions_function_name = std::source_location::current().function_name(); \
+        const auto& megatech_assertions_site_ref = *[]() noexcept -> const megatech::assertion_site* { \
+          static constinit auto megatech_assertions_counter = megatech::soft_assertion_counter{ }; \
+          MEGATECH_ASSERTIONS_SITE_SYMBOL(#exp) \
+          MEGATECH_ASSERTIONS_SITE_DECL auto megatech_assertions_site = \
+            MEGATECH_ASSERTIONS_SITE_INIT(#exp, msg, &megatech_assertions_counter); \
+          return &megatech_assertions_site; \
+        }(); \
+        if (MEGATECH_ASSERTIONS_SITE_ENABLED(megatech_assertions_site_ref)) \
+        { \
+          MEGATECH_ASSERTIONS_PROFILE_BEGIN(megatech_assertions_site_ref) \
+          function(megatech_assertions_site_ref, static_cast<bool>(exp) __VA_OPT__(,) __VA_ARGS__); \
+          MEGATECH_ASSERTIONS_PROFILE_END \
+        } \
+      } \
+    }))
+#else
+  #define MEGATECH_ASSERTIONS_SOFT_DISPATCH(function, exp, msg, ...) \
+    (std::is_constant_evaluated() ? \
+     megatech::internal::base::constant_evaluated_assertion(static_cast<bool>(exp), (#exp)) : \
+     function(megatech::assertion_site{ std::source_location::current().file_name(), \
+                                        std::source_location::current().line(), \
+                                        std::source_location::current().function_name(), (#exp), (msg), \
+                                        []() noexcept -> megatech::soft_assertion_counter* { \
+                                          static constinit auto megatech_assertions_counter = \
+                                            megatech::soft_assertion_counter{ }; \
+                                          return &megatech_assertions_counter; \
+                                        }() }, \
+              static_cast<bool>(exp) __VA_OPT__(,) __VA_ARGS__))
+#endif
+
+// Operand sites are used by assertions that report the values of their operands. The caller provides the expression
+// text, a format chosen at compile-time, a condition for constant evaluation, and the function that checks (and
+// reports) the operands at run-time. Every operand is evaluated exactly once along either path.
+#ifdef MEGATECH_ASSERTIONS_STATIC_SITES_AVAILABLE
+  #define MEGATECH_ASSERTIONS_OPERAND_DISPATCH(expression, format, condition, function, ...) \
+    (__extension__ ({ \
+      if (std::is_constant_evaluated()) \
+      { \
+        megatech::internal::base::constant_evaluated_assertion(static_cast<bool>(condition), (expression)); \
+      } \
+      else \
+      { \
+        constexpr const char* megatech_assertions_file_name = std::source_location::current().file_name(); \
+        constexpr std::uint_least32_t megatech_assertions_line = std::source_location::current().line(); \
+        constexpr const char* megatech_assertions_function_name = std::source_location::current().function_name(); \
+        constexpr const char* megatech_assertions_format = (format); \
+        const auto& megatech_assertions_site_ref = *[]() noexcept -> const megatech::assertion_site* { \
+          MEGATECH_ASSERTIONS_SITE_SYMBOL(expression) \
+          MEGATECH_ASSERTIONS_SITE_DECL auto megatech_assertions_site = \
+            MEGATECH_ASSERTIONS_SITE_INIT(expression, megatech_assertions_format, nullptr); \
+          return &megatech_assertions_site; \
+        }(); \
+        if (MEGATECH_ASSERTIONS_SITE_ENABLED(megatech_assertions_site_ref)) \
+        { \
+          MEGATECH_ASSERTIONS_PROFILE_BEGIN(megatech_assertions_site_ref) \
+          function(megatech_assertions_site_ref, __VA_ARGS__); \
+          MEGATECH_ASSERTIONS_PROFILE_END \
+        } \
+      } \
+    }))
+#else
+  #define MEGATECH_ASSERTIONS_OPERAND_DISPATCH(expression, format, condition, function, ...) \
+    (std::is_constant_evaluated() ? \
+     megatech::internal::base::constant_evaluated_assertion(static_cast<bool>(condition), (expression)) : \
+     function(megatech::assertion_site{ std::source_location::current().file_name(), \
+                                        std::source_location::current().line(), \
+                                        std::source_location::current().function_name(), (expression), (format) }, \
+              __VA_ARGS__))
+#endif
+
+// Comparisons choose their format from the operand types, so only the failure path ever looks at the operand values.
+// Whether "format"-style rendering may be chosen is a template argument. It only becomes true once the "format"
+// section of this file is processed, so a comparison compiled without <format> never names a different entity than
+// one compiled with it.
+#define MEGATECH_ASSERTIONS_FORMAT_COMPARISONS false
+#define MEGATECH_ASSERTIONS_COMPARE(compare, op, a, b) \
+  MEGATECH_ASSERTIONS_OPERAND_DISPATCH((#a " " #op " " #b), \
+                                       (megatech::internal::base::comparison_format< \
+                                          compare, MEGATECH_ASSERTIONS_FORMAT_COMPARISONS, decltype((a)), \
+                                          decltype((b))>.data()), \
+                                       ((a) op (b)), \
+                                       (megatech::debug_assertion_compare<compare, \
+                                                                          MEGATECH_ASSERTIONS_FORMAT_COMPARISONS>), \
+                                       (a), (b))
+
+// Every context scope needs a unique name, so the counter has to be expanded before it's pasted.
+#define MEGATECH_ASSERTIONS_CONCAT_EXPANDED(a, b) a##b
+#define MEGATECH_ASSERTIONS_CONCAT(a, b) MEGATECH_ASSERTIONS_CONCAT_EXPANDED(a, b)
+
+// Sampling counters are thread-local statics inside of a lambda. Each lambda expression has a unique type, so every
+// macro expansion gets its own counter even without statement expressions. Constant evaluation checks every pass.
+#define MEGATECH_ASSERTIONS_SAMPLE(n) \
+  (std::is_constant_evaluated() || megatech::internal::base::sample_assertion([]() noexcept -> std::uint_least32_t& { \
+    static thread_local auto megatech_assertions_countdown = std::uint_least32_t{ 0 }; \
+    return megatech_assertions_countdown; \
+  }(), (n)))
+
+// Categories are template arguments, so a category that isn't a constant expression is a compile error. A disabled
+// category selects a constant false branch, which is discarded even without optimization.
+#define MEGATECH_ASSERTIONS_CATEGORY_ENABLED(category) \
+  (megatech::internal::base::assertion_category_enabled< \
+     (category), static_cast<std::uint_least64_t>(MEGATECH_ASSERTIONS_CATEGORIES)>)
+
+// Optimizer hints never report anything. Compilers without a non-evaluating assumption evaluate the expression and
+// mark the false branch unreachable. Contracts are only lowered to hints that don't evaluate their expression, since
+// otherwise every opaque contract would be called in release builds.
+#if defined(__clang__)
+  #define MEGATECH_ASSERTIONS_ASSUME_HINT(exp) (__builtin_assume(static_cast<bool>(exp)))
+  #define MEGATECH_ASSERTIONS_CONTRACT_HINT(exp) MEGATECH_ASSERTIONS_ASSUME_HINT(exp)
+#elif defined(__GNUC__) && __has_cpp_attribute(gnu::assume)
+  #define MEGATECH_ASSERTIONS_ASSUME_HINT(exp) (__extension__ ({ [[gnu::assume(static_cast<bool>(exp))]]; }))
+  #define MEGATECH_ASSERTIONS_CONTRACT_HINT(exp) MEGATECH_ASSERTIONS_ASSUME_HINT(exp)
+#elif defined(__GNUC__)
+  #define MEGATECH_ASSERTIONS_ASSUME_HINT(exp) (static_cast<bool>(exp) ? void() : __builtin_unreachable())
+  #define MEGATECH_ASSERTIONS_CONTRACT_HINT(exp) ((void) 0)
+#elif defined(_MSC_VER)
+  #define MEGATECH_ASSERTIONS_ASSUME_HINT(exp) (__assume(static_cast<bool>(exp)))
+  #define MEGATECH_ASSERTIONS_CONTRACT_HINT(exp) MEGATECH_ASSERTIONS_ASSUME_HINT(exp)
+#else
+  #define MEGATECH_ASSERTIONS_ASSUME_HINT(exp) ((void) 0)
+  #define MEGATECH_ASSERTIONS_CONTRACT_HINT(exp) ((void) 0)
+#endif
+
+#ifdef MEGATECH_ASSERTIONS_ENABLED
+  #define MEGATECH_ASSERT_MSG_PRINTF(exp, msg, ...) \
+    MEGATECH_ASSERTIONS_DISPATCH(megatech::debug_assertion_printf, exp, msg __VA_OPT__(,) __VA_ARGS__)
+  #define MEGATECH_PRECONDITION_MSG_PRINTF(exp, msg, ...) \
+    MEGATECH_ASSERT_MSG_PRINTF(exp, msg __VA_OPT__(,) __VA_ARGS__)
+  #define MEGATECH_POSTCONDITION_MSG_PRINTF(exp, msg, ...) \
+    MEGATECH_ASSERT_MSG_PRINTF(exp, msg __VA_OPT__(,) __VA_ARGS__)
+  #ifdef MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_PRINTF
+    #define MEGATECH_ASSERT_MSG(exp, msg, ...) MEGATECH_ASSERT_MSG_PRINTF(exp, msg __VA_OPT__(,) __VA_ARGS__)
+  #endif
+  #define MEGATECH_ASSERT(exp) MEGATECH_ASSERTIONS_DISPATCH(megatech::debug_assertion, exp, nullptr)
+  #define MEGATECH_ASSERT_EQ(a, b) MEGATECH_ASSERTIONS_COMPARE(megatech::internal::base::equal_to, ==, a, b)
+  #define MEGATECH_ASSERT_NE(a, b) MEGATECH_ASSERTIONS_COMPARE(megatech::internal::base::not_equal_to, !=, a, b)
+  #define MEGATECH_ASSERT_LT(a, b) MEGATECH_ASSERTIONS_COMPARE(megatech::internal::base::less, <, a, b)
+  #define MEGATECH_ASSERT_LE(a, b) MEGATECH_ASSERTIONS_COMPARE(megatech::internal::base::less_equal, <=, a, b)
+  #define MEGATECH_ASSERT_GT(a, b) MEGATECH_ASSERTIONS_COMPARE(megatech::internal::base::greater, >, a, b)
+  #define MEGATECH_ASSERT_GE(a, b) MEGATECH_ASSERTIONS_COMPARE(megatech::internal::base::greater_equal, >=, a, b)
+  #define MEGATECH_PRECONDITION_MSG(exp, msg, ...) MEGATECH_ASSERT_MSG(exp, msg __VA_OPT__(,) __VA_ARGS__)
+  #define MEGATECH_PRECONDITION(exp) MEGATECH_ASSERT(exp)
+  #define MEGATECH_POSTCONDITION_MSG(exp, msg, ...) MEGATECH_ASSERT_MSG(exp, msg __VA_OPT__(,) __VA_ARGS__)
+  #define MEGATECH_POSTCONDITION(exp) MEGATECH_ASSERT(exp)
+  #define MEGATECH_ASSUME(exp) MEGATECH_ASSERT(exp)
+  #define MEGATECH_ASSERT_SAMPLED(exp, n) (MEGATECH_ASSERTIONS_SAMPLE(n) ? MEGATECH_ASSERT(exp) : void())
+  #define MEGATECH_ASSERT_SAMPLED_MSG(exp, n, msg, ...) \
+    (MEGATECH_ASSERTIONS_SAMPLE(n) ? MEGATECH_ASSERT_MSG(exp, msg __VA_OPT__(,) __VA_ARGS__) : void())
+  #define MEGATECH_ASSERT_SAMPLED_MSG_PRINTF(exp, n, msg, ...) \
+    (MEGATECH_ASSERTIONS_SAMPLE(n) ? MEGATECH_ASSERT_MSG_PRINTF(exp, msg __VA_OPT__(,) __VA_ARGS__) : void())
+  #define MEGATECH_ASSERT_IN(category, exp) \
+    (MEGATECH_ASSERTIONS_CATEGORY_ENABLED(category) ? MEGATECH_ASSERT(exp) : void())
+  #define MEGATECH_ASSERT_IN_MSG(category, exp, msg, ...) \
+    (MEGATECH_ASSERTIONS_CATEGORY_ENABLED(category) ? MEGATECH_ASSERT_MSG(exp, msg __VA_OPT__(,) __VA_ARGS__) : void())
+  #define MEGATECH_ASSERT_IN_MSG_PRINTF(category, exp, msg, ...) \
+    (MEGATECH_ASSERTIONS_CATEGORY_ENABLED(category) ? \
+     MEGATECH_ASSERT_MSG_PRINTF(exp, msg __VA_OPT__(,) __VA_ARGS__) : void())
+#else
+  #define MEGATECH_ASSERT(exp) ((void) 0)
+  #define MEGATECH_ASSERT_EQ(a, b) ((void) 0)
+  #define MEGATECH_ASSERT_NE(a, b) ((void) 0)
+  #define MEGATECH_ASSERT_LT(a, b) ((void) 0)
+  #define MEGATECH_ASSERT_LE(a, b) ((void) 0)
+  #define MEGATECH_ASSERT_GT(a, b) ((void) 0)
+  #define MEGATECH_ASSERT_GE(a, b) ((void) 0)
+  #define MEGATECH_ASSERT_MSG(exp, msg, ...) ((void) 0)
+  #define MEGATECH_ASSERT_MSG_PRINTF(exp, msg, ...) ((void) 0)
+  #define MEGATECH_ASSUME(exp) MEGATECH_ASSERTIONS_ASSUME_HINT(exp)
+  #ifdef MEGATECH_ASSERTIONS_ASSUME_CONTRACTS
+    #define MEGATECH_PRECONDITION(exp) MEGATECH_ASSERTIONS_CONTRACT_HINT(exp)
+    #define MEGATECH_PRECONDITION_MSG(exp, msg, ...) MEGATECH_ASSERTIONS_CONTRACT_HINT(exp)
+    #define MEGATECH_PRECONDITION_MSG_PRINTF(exp, msg, ...) MEGATECH_ASSERTIONS_CONTRACT_HINT(exp)
+    #define MEGATECH_POSTCONDITION(exp) MEGATECH_ASSERTIONS_CONTRACT_HINT(exp)
+    #define MEGATECH_POSTCONDITION_MSG(exp, msg, ...) MEGATECH_ASSERTIONS_CONTRACT_HINT(exp)
+    #define MEGATECH_POSTCONDITION_MSG_PRINTF(exp, msg, ...) MEGATECH_ASSERTIONS_CONTRACT_HINT(exp)
+  #else
+    #define MEGATECH_PRECONDITION(exp) ((void) 0)
+    #define MEGATECH_PRECONDITION_MSG(exp, msg, ...) ((void) 0)
+    #define MEGATECH_PRECONDITION_MSG_PRINTF(exp, msg, ...) ((void) 0)
+    #define MEGATECH_POSTCONDITION(exp) ((void) 0)
+    #define MEGATECH_POSTCONDITION_MSG(exp, msg, ...) ((void) 0)
+    #define MEGATECH_POSTCONDITION_MSG_PRINTF(exp, msg, ...) ((void) 0)
+  #endif
+  #define MEGATECH_ASSERT_SAMPLED(exp, n) ((void) 0)
+  #define MEGATECH_ASSERT_SAMPLED_MSG(exp, n, msg, ...) ((void) 0)
+  #define MEGATECH_ASSERT_SAMPLED_MSG_PRINTF(exp, n, msg, ...) ((void) 0)
+  #define MEGATECH_ASSERT_IN(category, exp) ((void) 0)
+  #define MEGATECH_ASSERT_IN_MSG(category, exp, msg, ...) ((void) 0)
+  #define MEGATECH_ASSERT_IN_MSG_PRINTF(category, exp, msg, ...) ((void) 0)
+#endif
+
+#if MEGATECH_ASSERTIONS_LEVEL >= MEGATECH_ASSERTIONS_LEVEL_AUDIT
+  #define MEGATECH_ASSERT_AUDIT_MSG(exp, msg, ...) MEGATECH_ASSERT_MSG(exp, msg __VA_OPT__(,) __VA_ARGS__)
+  #define MEGATECH_ASSERT_AUDIT_MSG_PRINTF(exp, msg, ...) MEGATECH_ASSERT_MSG_PRINTF(exp, msg __VA_OPT__(,) __VA_ARGS__)
+  #define MEGATECH_ASSERT_AUDIT(exp) MEGATECH_ASSERT(exp)
+#else
+  #define MEGATECH_ASSERT_AUDIT(exp) ((void) 0)
+  #define MEGATECH_ASSERT_AUDIT_MSG(exp, msg, ...) ((void) 0)
+  #define MEGATECH_ASSERT_AUDIT_MSG_PRINTF(exp, msg, ...) ((void) 0)
+#endif
+
+// The operand of sizeof is never evaluated, but it still has to be well-formed.
+#define MEGATECH_ASSERT_AXIOM(exp) ((void) sizeof((exp) ? true : false))
+
+#ifndef MEGATECH_ASSERTIONS_SOFT_DISABLED
+  #define MEGATECH_SOFT_ASSERT_MSG_PRINTF(exp, msg, ...) \
+    MEGATECH_ASSERTIONS_SOFT_DISPATCH(megatech::soft_assertion_printf, exp, msg __VA_OPT__(,) __VA_ARGS__)
+  #ifdef MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_PRINTF
+    #define MEGATECH_SOFT_ASSERT_MSG(exp, msg, ...) MEGATECH_SOFT_ASSERT_MSG_PRINTF(exp, msg __VA_OPT__(,) __VA_ARGS__)
+  #endif
+  #define MEGATECH_SOFT_ASSERT(exp) MEGATECH_ASSERTIONS_SOFT_DISPATCH(megatech::soft_assertion, exp, nullptr)
+#else
+  #define MEGATECH_SOFT_ASSERT(exp) ((void) 0)
+  #define MEGATECH_SOFT_ASSERT_MSG(exp, msg, ...) ((void) 0)
+  #define MEGATECH_SOFT_ASSERT_MSG_PRINTF(exp, msg, ...) ((void) 0)
+#endif
+
+#define MEGATECH_ASSERTIONS_AVAILABLE (1)
+
+// Failure handlers are kept out of line and out of the hot path. Passing assertions should reduce to a single test and
+// branch at each call site.
+#if defined(__GNUC__)
+  #define MEGATECH_ASSERTIONS_COLD [[gnu::cold, gnu::noinline]]
+  #define MEGATECH_ASSERTIONS_INLINE [[gnu::always_inline]] inline
+#elif defined(_MSC_VER)
+  #define MEGATECH_ASSERTIONS_COLD __declspec(noinline)
+  #define MEGATECH_ASSERTIONS_INLINE __forceinline
+#else
+  #define MEGATECH_ASSERTIONS_COLD
+  #define MEGATECH_ASSERTIONS_INLINE inline
+#endif
+/// @endcond
+#endif
+
+// The "format" section has its own guard. It's processed the first time that this file is included after <format> is
+// available, which might be long after the section above.
+#if defined(MEGATECH_ASSERTIONS_FORMAT_AVAILABLE) && !defined(MEGATECH_ASSERTIONS_FORMAT_MACROS)
+#define MEGATECH_ASSERTIONS_FORMAT_MACROS (1)
+
+/// @cond
+#undef MEGATECH_ASSERTIONS_FORMAT_COMPARISONS
+#define MEGATECH_ASSERTIONS_FORMAT_COMPARISONS true
+
+#ifdef MEGATECH_ASSERTIONS_ENABLED
+  #define MEGATECH_ASSERT_MSG_FORMAT(exp, msg, ...) \
+    MEGATECH_ASSERTIONS_DISPATCH(megatech::debug_assertion_format, exp, msg, msg __VA_OPT__(,) __VA_ARGS__)
+  #define MEGATECH_PRECONDITION_MSG_FORMAT(exp, msg, ...) \
+    MEGATECH_ASSERT_MSG_FORMAT(exp, msg __VA_OPT__(,) __VA_ARGS__)
+  #define MEGATECH_POSTCONDITION_MSG_FORMAT(exp, msg, ...) \
+    MEGATECH_ASSERT_MSG_FORMAT(exp, msg __VA_OPT__(,) __VA_ARGS__)
+  #ifdef MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT
+    #define MEGATECH_ASSERT_MSG(exp, msg, ...) MEGATECH_ASSERT_MSG_FORMAT(exp, msg __VA_OPT__(,) __VA_ARGS__)
+  #endif
+  #define MEGATECH_ASSERT_SAMPLED_MSG_FORMAT(exp, n, msg, ...) \
+    (MEGATECH_ASSERTIONS_SAMPLE(n) ? MEGATECH_ASSERT_MSG_FORMAT(exp, msg __VA_OPT__(,) __VA_ARGS__) : void())
+  #define MEGATECH_ASSERT_IN_MSG_FORMAT(category, exp, msg, ...) \
+    (MEGATECH_ASSERTIONS_CATEGORY_ENABLED(category) ? \
+     MEGATECH_ASSERT_MSG_FORMAT(exp, msg __VA_OPT__(,) __VA_ARGS__) : void())
+  #define MEGATECH_ASSERT_CONTEXT(msg, ...) \
+    const auto MEGATECH_ASSERTIONS_CONCAT(megatech_assertions_context_, __COUNTER__) = \
+      megatech::internal::base::make_assertion_context(msg __VA_OPT__(,) __VA_ARGS__)
+#else
+  #define MEGATECH_ASSERT_MSG_FORMAT(exp, msg, ...) ((void) 0)
+  #define MEGATECH_ASSERT_SAMPLED_MSG_FORMAT(exp, n, msg, ...) ((void) 0)
+  #define MEGATECH_ASSERT_IN_MSG_FORMAT(category, exp, msg, ...) ((void) 0)
+  #define MEGATECH_ASSERT_CONTEXT(msg, ...) static_assert(true)
+  #ifdef MEGATECH_ASSERTIONS_ASSUME_CONTRACTS
+    #define MEGATECH_PRECONDITION_MSG_FORMAT(exp, msg, ...) MEGATECH_ASSERTIONS_CONTRACT_HINT(exp)
+    #define MEGATECH_POSTCONDITION_MSG_FORMAT(exp, msg, ...) MEGATECH_ASSERTIONS_CONTRACT_HINT(exp)
+  #else
+    #define MEGATECH_PRECONDITION_MSG_FORMAT(exp, msg, ...) ((void) 0)
+    #define MEGATECH_POSTCONDITION_MSG_FORMAT(exp, msg, ...) ((void) 0)
+  #endif
+#endif
+
+#if MEGATECH_ASSERTIONS_LEVEL >= MEGATECH_ASSERTIONS_LEVEL_AUDIT
+  #define MEGATECH_ASSERT_AUDIT_MSG_FORMAT(exp, msg, ...) MEGATECH_ASSERT_MSG_FORMAT(exp, msg __VA_OPT__(,) __VA_ARGS__)
+#else
+  #define MEGATECH_ASSERT_AUDIT_MSG_FORMAT(exp, msg, ...) ((void) 0)
+#endif
+
+#ifndef MEGATECH_ASSERTIONS_SOFT_DISABLED
+  #define MEGATECH_SOFT_ASSERT_MSG_FORMAT(exp, msg, ...) \
+    MEGATECH_ASSERTIONS_SOFT_DISPATCH(megatech::soft_assertion_format, exp, msg, msg __VA_OPT__(,) __VA_ARGS__)
+  #ifdef MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT
+    #define MEGATECH_SOFT_ASSERT_MSG(exp, msg, ...) MEGATECH_SOFT_ASSERT_MSG_FORMAT(exp, msg __VA_OPT__(,) __VA_ARGS__)
+  #endif
+#else
+  #define MEGATECH_SOFT_ASSERT_MSG_FORMAT(exp, msg, ...) ((void) 0)
+#endif
+/// @endcond
+
+#endif
@@ -0,0 +1,176 @@
+/**
+ * @file metrics.hpp
+ * @brief Shared-Memory Assertion Metrics
+ * @details Metrics are an optional POSIX shared-memory segment that publishes per-site assertion statistics to other
+ *          processes. Each site has its own cache-line-aligned record protected by a sequence lock, so readers never
+ *          block the process and never observe a partially written record. The `megatech-assertions-metrics` tool
+ *          prints a live segment as a table or in the Prometheus text format.
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2024
+ */
+#ifndef MEGATECH_ASSERTIONS_METRICS_HPP
+#define MEGATECH_ASSERTIONS_METRICS_HPP
+
+#include <megatech/assertions.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <span>
+
+namespace megatech {
+
+  /**
+   * @brief The header at the beginning of a metrics segment.
+   * @details Every field is stored in the byte order of the process that created the segment.
+   */
+  struct alignas(64) assertion_metrics_header final {
+    /**
+     * @brief The magic number identifying a metrics segment.
+     */
+    static constexpr std::array<char, 8> magic_value{ 'M', 'T', 'A', 'S', 'M', 'T', 'R', 'C' };
+
+    /**
+     * @brief The current version of the metrics format.
+     */
+    static constexpr std::uint32_t current_version = 1;
+
+    /**
+     * @brief The magic number. This is always magic_value.
+     */
+    std::array<char, 8> magic{ };
+
+    /**
+     * @brief The version of the metrics format.
+     */
+    std::uint32_t version{ };
+
+    /**
+     * @brief The size of each record in bytes.
+     */
+    std::uint32_t record_size{ };
+
+    /**
+     * @brief The number of records in the segment.
+     */
+    std::uint64_t capacity{ };
+
+    /**
+     * @brief The number of records that have been claimed by sites.
+     */
+    std::uint64_t claimed{ };
+
+    /**
+     * @brief The number of sites that couldn't be published because every record was claimed.
+     */
+    std::uint64_t overflow{ };
+
+    /**
+     * @brief The ID of the process that publishes the segment.
+     */
+    std::uint64_t process{ };
+  };
+
+  /**
+   * @brief The published statistics of a single assertion site.
+   * @details Records are stored in an open-addressed table, so claimed records aren't necessarily contiguous. A
+   *          record is being written whenever its sequence number is odd. Readers **MUST** copy the record and then
+   *          check that the sequence number is even and unchanged. Strings are NUL-terminated and truncated to fit.
+   */
+  struct alignas(64) assertion_metrics_record final {
+    /**
+     * @brief The record's sequence number. This is 0 if the record has never been published.
+     */
+    std::uint64_t sequence{ };
+
+    /**
+     * @brief The address of the site in the publishing process. This is 0 if the record is unclaimed.
+     */
+    std::uint64_t site{ };
+
+    /**
+     * @brief The number of times that the site's soft assertion failed.
+     */
+    std::uint64_t failures{ };
+
+    /**
+     * @brief The number of times that the site was evaluated. This is 0 unless the site is profiled.
+     */
+    std::uint64_t evaluations{ };
+
+    /**
+     * @brief The time spent evaluating the site. This is 0 unless the site is profiled with
+     *        ::MEGATECH_ASSERTIONS_PROFILE_CYCLES defined.
+     */
+    std::uint64_t cycles{ };
+
+    /**
+     * @brief The line number of the site.
+     */
+    std::uint32_t line{ };
+
+    /**
+     * @brief The ID of the site. This is 0 unless the site is compact.
+     */
+    std::uint32_t id{ };
+
+    /**
+     * @brief The name of the file containing the site.
+     */
+    std::array<char, 144> file_name{ };
+
+    /**
+     * @brief The name of the function containing the site.
+     */
+    std::array<char, 192> function_name{ };
+
+    /**
+     * @brief The site's expression.
+     */
+    std::array<char, 128> expression{ };
+  };
+
+  static_assert(sizeof(assertion_metrics_header) == 64);
+  static_assert(sizeof(assertion_metrics_record) == 512);
+
+  /**
+   * @brief Begin publishing assertion metrics in a shared-memory segment.
+   * @details The segment is created, or replaced if it already exists. Opening a segment replaces any previously
+   *          opened segment. The previous mapping is never removed, since failing threads may still be writing to it.
+   *          If the `MEGATECH_ASSERTIONS_METRICS` environment variable names a segment, a segment with a capacity of
+   *          256 records is opened automatically during static initialization. Soft assertion failures update their
+   *          site's record as they happen. Other statistics are only published by update_assertion_metrics().
+   * @param name The name of the segment (e.g., `"/program.assertions"`). This **MUST** be a NUL-terminated string.
+   * @param capacity The number of records in the segment. This **MUST** be greater than 0.
+   * @return True if the segment was opened. False otherwise. This is always false if shared memory isn't supported.
+   */
+  bool open_assertion_metrics(const char* name, const std::size_t capacity) noexcept;
+
+  /**
+   * @brief Publish the current statistics of a set of sites.
+   * @details This is thread-safe, but it isn't async-signal-safe. Profiled evaluations are combined across every
+   *          thread, so this takes time proportional to the number of sites multiplied by the number of profiles.
+   *          Nothing happens if no segment is open.
+   * @param sites The sites to publish. Usually, this is the result of megatech::assertion_sites().
+   */
+  void update_assertion_metrics(const std::span<const assertion_site> sites) noexcept;
+
+}
+
+/// @cond INTERNAL
+namespace megatech::internal::base {
+
+  /**
+   * @brief Publish the failure count of a site in the current segment, if there is one.
+   * @details This never allocates or makes a system call. It is async-signal-safe.
+   * @param site The site that failed.
+   * @param failures The site's failure count after the failure.
+   */
+  void publish_assertion_failures(const assertion_site& site, const std::uint_least64_t failures) noexcept;
+
+}
+/// @endcond
+
+#endif
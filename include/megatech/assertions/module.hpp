@@ -0,0 +1,39 @@
+/**
+ * @file module.hpp
+ * @brief Assertion Macros for the megatech.assertions Module
+ * @details Named modules can't export macros, so translation units that `import megatech.assertions;` include this
+ *          to get the assertion macros. It only includes `megatech/assertions/macros.hpp`, so no declarations are
+ *          parsed twice.
+ *
+ *          Configuration macros (e.g., ::MEGATECH_ASSERTIONS_RUNTIME_TOGGLES or
+ *          ::MEGATECH_ASSERTIONS_FORMAT_UNAVAILABLE) **MUST** match the ones used to build the module. The default
+ *          formatter is chosen in the same way as it is by `megatech/assertions.hpp`.
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2024
+ */
+#ifndef MEGATECH_ASSERTIONS_MODULE_HPP
+#define MEGATECH_ASSERTIONS_MODULE_HPP
+
+/// @cond
+#if __has_include(<format>) && !defined(MEGATECH_ASSERTIONS_FORMAT_UNAVAILABLE)
+  #if !defined(MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_PRINTF) && !defined(MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT)
+    #define MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT (1)
+  #endif
+  // The module exports the "format"-style assertions, so their macros are needed too.
+  #ifndef MEGATECH_ASSERTIONS_FORMAT_AVAILABLE
+    #define MEGATECH_ASSERTIONS_FORMAT_AVAILABLE (1)
+  #endif
+#else
+  #ifndef MEGATECH_ASSERTIONS_FORMAT_UNAVAILABLE
+    #define MEGATECH_ASSERTIONS_FORMAT_UNAVAILABLE (1)
+  #endif
+  #ifdef MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT
+    #error "<format> based assertions are not available."
+  #endif
+#endif
+/// @endcond
+
+#include <megatech/assertions/macros.hpp>
+
+#endif
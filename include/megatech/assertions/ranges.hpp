@@ -0,0 +1,488 @@
+/**
+ * @file ranges.hpp
+ * @brief Run-Time Range Assertions
+ * @details Range assertions check a property of every element in a contiguous range (e.g., a `std::span`,
+ *          `std::vector`, or array). Elements are checked in fixed-size blocks without any early exit, so the checks
+ *          can be vectorized. Only the first failing element is reported. Like every other assertion, range
+ *          assertions are equivalent to `((void) 0)` when disabled.
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2024
+ */
+#ifndef MEGATECH_ASSERTIONS_RANGES_HPP
+#define MEGATECH_ASSERTIONS_RANGES_HPP
+
+// Don't define this outside doxygen.
+#ifdef __DOXYGEN__
+  /**
+   * @def MEGATECH_ASSERT_ALL
+   * @brief Assert that a predicate is true for every element of a range.
+   * @details The range is evaluated exactly once. When the assertion fails, the index and value of the first element
+   *          that doesn't satisfy the predicate are rendered into the diagnostic message (e.g., `index 3 is -1`).
+   *          The predicate is invoked on every element of a block before the block is tested, so it must not have
+   *          side effects.
+   * @param range A contiguous range. This **MUST** be convertible to a `std::span`.
+   * @param predicate A function object accepting an element of the range and returning a value convertible to
+   *                  `bool`.
+   */
+  #define MEGATECH_ASSERT_ALL(range, predicate)
+
+  /**
+   * @def MEGATECH_ASSERT_ALL_FINITE
+   * @brief Assert that every element of a floating point range is finite (i.e., neither infinite nor NaN).
+   * @details `float` and `double` ranges are checked by the library's vectorized kernels.
+   * @param range A contiguous range of floating point values. This **MUST** be convertible to a `std::span`.
+   * @see ::MEGATECH_ASSERT_ALL
+   */
+  #define MEGATECH_ASSERT_ALL_FINITE(range)
+
+  /**
+   * @def MEGATECH_ASSERT_ALL_IN_RANGE
+   * @brief Assert that every element of a range is in the half-open interval `[low, high)`.
+   * @details Elements are compared with the bounds as they are, so bounds that the element type can't represent
+   *          (e.g., `256` for a range of `std::uint8_t`) behave as they would in ordinary arithmetic. Integers are
+   *          compared by value, even when only one of them is signed. 32-bit and 64-bit integer, `float`, and
+   *          `double` ranges are checked by the library's vectorized kernels whenever the element type can represent
+   *          both bounds exactly. NaN is never in range.
+   * @param range A contiguous range of arithmetic values. This **MUST** be convertible to a `std::span`.
+   * @param low The inclusive lower bound.
+   * @param high The exclusive upper bound.
+   * @see ::MEGATECH_ASSERT_ALL
+   */
+  #define MEGATECH_ASSERT_ALL_IN_RANGE(range, low, high)
+
+  /**
+   * @def MEGATECH_ASSERT_SORTED
+   * @brief Assert that a range is sorted in non-descending order.
+   * @details The first element that compares less than its predecessor is reported. 32-bit and 64-bit integer,
+   *          `float`, and `double` ranges are checked by the library's vectorized kernels. Elements are only compared
+   *          with `<`, so NaN never causes a failure.
+   * @param range A contiguous range. This **MUST** be convertible to a `std::span`.
+   * @see ::MEGATECH_ASSERT_ALL
+   */
+  #define MEGATECH_ASSERT_SORTED(range)
+
+  #undef MEGATECH_ASSERT_ALL
+  #undef MEGATECH_ASSERT_ALL_FINITE
+  #undef MEGATECH_ASSERT_ALL_IN_RANGE
+  #undef MEGATECH_ASSERT_SORTED
+#endif
+
+#include <megatech/assertions.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+/// @cond
+#define MEGATECH_ASSERTIONS_RANGE(expression, range, search) \
+  MEGATECH_ASSERTIONS_OPERAND_DISPATCH((expression), \
+                                       (megatech::internal::base::range_format< \
+                                          megatech::internal::base::range_element_t<decltype((range))>>.data()), \
+                                       (megatech::internal::base::range_satisfies( \
+                                          megatech::internal::base::range_span(range), search)), \
+                                       megatech::debug_assertion_range, megatech::internal::base::range_span(range), \
+                                       search)
+
+#ifdef MEGATECH_ASSERTIONS_ENABLED
+  #define MEGATECH_ASSERT_ALL(range, predicate) \
+    MEGATECH_ASSERTIONS_RANGE(("all_of(" #range ", " #predicate ")"), range, \
+                              (megatech::internal::base::predicate_search{ (predicate) }))
+  #define MEGATECH_ASSERT_ALL_FINITE(range) \
+    MEGATECH_ASSERTIONS_RANGE(("all_finite(" #range ")"), range, (megatech::internal::base::finite_search{ }))
+  #define MEGATECH_ASSERT_ALL_IN_RANGE(range, low, high) \
+    MEGATECH_ASSERTIONS_RANGE(("all_in_range(" #range ", " #low ", " #high ")"), range, \
+                              (megatech::internal::base::in_range_search{ (low), (high) }))
+  #define MEGATECH_ASSERT_SORTED(range) \
+    MEGATECH_ASSERTIONS_RANGE(("is_sorted(" #range ")"), range, (megatech::internal::base::sorted_search{ }))
+#else
+  #define MEGATECH_ASSERT_ALL(range, predicate) ((void) 0)
+  #define MEGATECH_ASSERT_ALL_FINITE(range) ((void) 0)
+  #define MEGATECH_ASSERT_ALL_IN_RANGE(range, low, high) ((void) 0)
+  #define MEGATECH_ASSERT_SORTED(range) ((void) 0)
+#endif
+/// @endcond
+
+/// @cond INTERNAL
+namespace megatech::internal::base {
+
+  /**
+   * @brief Find the first non-finite element of a range.
+   * @param values The range to search.
+   * @return The index of the first infinite or NaN element. If every element is finite, this is `values.size()`.
+   */
+  std::size_t find_non_finite(const std::span<const float> values) noexcept;
+
+  /**
+   * @copydoc find_non_finite(const std::span<const float>)
+   */
+  std::size_t find_non_finite(const std::span<const double> values) noexcept;
+
+  /**
+   * @brief Find the first element of a range that is outside of the interval `[low, high)`.
+   * @param values The range to search.
+   * @param low The inclusive lower bound.
+   * @param high The exclusive upper bound.
+   * @return The index of the first element outside of the interval. If every element is inside of the interval, this
+   *         is `values.size()`.
+   */
+  std::size_t find_out_of_range(const std::span<const std::int32_t> values, const std::int32_t low,
+                                const std::int32_t high) noexcept;
+
+  /**
+   * @copydoc find_out_of_range(const std::span<const std::int32_t>, const std::int32_t, const std::int32_t)
+   */
+  std::size_t find_out_of_range(const std::span<const std::uint32_t> values, const std::uint32_t low,
+                                const std::uint32_t high) noexcept;
+
+  /**
+   * @copydoc find_out_of_range(const std::span<const std::int32_t>, const std::int32_t, const std::int32_t)
+   */
+  std::size_t find_out_of_range(const std::span<const std::int64_t> values, const std::int64_t low,
+                                const std::int64_t high) noexcept;
+
+  /**
+   * @copydoc find_out_of_range(const std::span<const std::int32_t>, const std::int32_t, const std::int32_t)
+   */
+  std::size_t find_out_of_range(const std::span<const std::uint64_t> values, const std::uint64_t low,
+                                const std::uint64_t high) noexcept;
+
+  /**
+   * @copydoc find_out_of_range(const std::span<const std::int32_t>, const std::int32_t, const std::int32_t)
+   */
+  std::size_t find_out_of_range(const std::span<const float> values, const float low, const float high) noexcept;
+
+  /**
+   * @copydoc find_out_of_range(const std::span<const std::int32_t>, const std::int32_t, const std::int32_t)
+   */
+  std::size_t find_out_of_range(const std::span<const double> values, const double low, const double high) noexcept;
+
+  /**
+   * @brief Find the first element of a range that compares less than its predecessor.
+   * @param values The range to search.
+   * @return The index of the first element that is less than its predecessor. If the range is sorted, this is
+   *         `values.size()`.
+   */
+  std::size_t find_unsorted(const std::span<const std::int32_t> values) noexcept;
+
+  /**
+   * @copydoc find_unsorted(const std::span<const std::int32_t>)
+   */
+  std::size_t find_unsorted(const std::span<const std::uint32_t> values) noexcept;
+
+  /**
+   * @copydoc find_unsorted(const std::span<const std::int32_t>)
+   */
+  std::size_t find_unsorted(const std::span<const std::int64_t> values) noexcept;
+
+  /**
+   * @copydoc find_unsorted(const std::span<const std::int32_t>)
+   */
+  std::size_t find_unsorted(const std::span<const std::uint64_t> values) noexcept;
+
+  /**
+   * @copydoc find_unsorted(const std::span<const std::int32_t>)
+   */
+  std::size_t find_unsorted(const std::span<const float> values) noexcept;
+
+  /**
+   * @copydoc find_unsorted(const std::span<const std::int32_t>)
+   */
+  std::size_t find_unsorted(const std::span<const double> values) noexcept;
+
+  /**
+   * @brief Determine whether a range's element type is handled by the library's kernels.
+   * @tparam Type The element type.
+   */
+  template <typename Type>
+  constexpr bool range_kernel_type_v = std::is_same_v<Type, std::int32_t> || std::is_same_v<Type, std::uint32_t> ||
+                                       std::is_same_v<Type, std::int64_t> || std::is_same_v<Type, std::uint64_t> ||
+                                       std::is_same_v<Type, float> || std::is_same_v<Type, double>;
+
+  /**
+   * @brief The (unqualified) element type of a contiguous range.
+   * @tparam Range The type of the range.
+   */
+  template <typename Range>
+  using range_element_t =
+    std::remove_cv_t<typename decltype(std::span{ std::declval<const std::remove_cvref_t<Range>&>() })::element_type>;
+
+  /**
+   * @brief View a contiguous range as a span of constant elements.
+   * @param range The range to view.
+   * @return A span covering the whole range.
+   */
+  template <typename Range>
+  constexpr std::span<const range_element_t<Range>> range_span(const Range& range) noexcept {
+    return std::span{ range };
+  }
+
+  /**
+   * @brief Find the first index in `[begin, end)` that doesn't satisfy a predicate.
+   * @details Indices are tested in fixed-size blocks. Every index in a block is tested before the block's result is
+   *          examined, so the compiler is free to vectorize each block. Only a failing block is searched again,
+   *          one index at a time, to find its first failure.
+   * @param begin The first index to test.
+   * @param end One past the last index to test.
+   * @param predicate A function object accepting an index.
+   * @return The first index that failed. If every index passed, this is `end`.
+   */
+  template <typename Predicate>
+  MEGATECH_ASSERTIONS_INLINE
+  constexpr std::size_t find_first_failure(const std::size_t begin, const std::size_t end,
+                                           const Predicate& predicate) noexcept {
+    constexpr auto block_size = std::size_t{ 64 };
+    auto index = begin;
+    for (; end - index >= block_size; index += block_size)
+    {
+      auto failures = 0u;
+      for (auto offset = std::size_t{ 0 }; offset < block_size; ++offset)
+      {
+        failures |= !predicate(index + offset);
+      }
+      if (failures)
+      {
+        break;
+      }
+    }
+    for (; index < end; ++index)
+    {
+      if (!predicate(index))
+      {
+        return index;
+      }
+    }
+    return end;
+  }
+
+  /**
+   * @brief A range search for elements that don't satisfy a predicate.
+   * @tparam Predicate The type of the predicate.
+   */
+  template <typename Predicate>
+  struct predicate_search final {
+    Predicate predicate;
+
+    template <typename Type>
+    constexpr std::size_t operator()(const std::span<const Type> values) const noexcept {
+      const auto data = values.data();
+      return find_first_failure(0, values.size(), [this, data](const std::size_t i) {
+        return static_cast<bool>(predicate(data[i]));
+      });
+    }
+  };
+
+  /**
+   * @brief A range search for non-finite floating point elements.
+   */
+  struct finite_search final {
+    template <typename Type>
+    constexpr std::size_t operator()(const std::span<const Type> values) const noexcept {
+      static_assert(std::is_floating_point_v<Type>, "Only floating point ranges can be checked for finite values.");
+      if constexpr (range_kernel_type_v<Type>)
+      {
+        if (!std::is_constant_evaluated())
+        {
+          return find_non_finite(values);
+        }
+      }
+      const auto data = values.data();
+      // Infinity and NaN are the only values for which this is false.
+      return find_first_failure(0, values.size(), [data](const std::size_t i) {
+        return data[i] - data[i] == Type{ 0 };
+      });
+    }
+  };
+
+  /**
+   * @brief Determine whether one arithmetic value is less than another.
+   * @details Unlike the built-in `<`, integers of different signedness are compared by value (e.g., `-1` is less than
+   *          `0u`), and integers are compared with `float` values in (at least) `double` precision.
+   * @param left The left operand.
+   * @param right The right operand.
+   * @return True if `left` is less than `right`. Otherwise, false.
+   */
+  template <typename Left, typename Right>
+  constexpr bool range_less(const Left left, const Right right) noexcept {
+    if constexpr (std::is_floating_point_v<Left> != std::is_floating_point_v<Right>)
+    {
+      using common_type = std::common_type_t<Left, Right, double>;
+      return static_cast<common_type>(left) < static_cast<common_type>(right);
+    }
+    else if constexpr (std::is_integral_v<Left> && std::is_integral_v<Right> &&
+                       std::is_signed_v<Left> != std::is_signed_v<Right>)
+    {
+      if constexpr (std::is_signed_v<Left>)
+      {
+        return left < 0 || static_cast<std::make_unsigned_t<Left>>(left) < right;
+      }
+      else
+      {
+        return right > 0 && left < static_cast<std::make_unsigned_t<Right>>(right);
+      }
+    }
+    else
+    {
+      return left < right;
+    }
+  }
+
+  /**
+   * @brief Determine whether a range bound is exactly representable by a range's element type.
+   * @details Only exactly representable bounds can be passed to the library's kernels.
+   * @tparam Type The element type.
+   * @param bound The bound.
+   * @return True if converting `bound` to `Type` doesn't change its value. Otherwise, false.
+   */
+  template <typename Type, typename Bound>
+  constexpr bool range_bound_representable(const Bound bound) noexcept {
+    if constexpr (std::is_integral_v<Type> && std::is_integral_v<Bound>)
+    {
+      return !range_less(bound, std::numeric_limits<Type>::min()) &&
+             !range_less(std::numeric_limits<Type>::max(), bound);
+    }
+    else if constexpr (std::is_floating_point_v<Type>)
+    {
+      return static_cast<Bound>(static_cast<Type>(bound)) == bound;
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  /**
+   * @brief A range search for elements outside of the interval `[low, high)`.
+   * @tparam Low The type of the lower bound.
+   * @tparam High The type of the upper bound.
+   */
+  template <typename Low, typename High>
+  struct in_range_search final {
+    Low low;
+    High high;
+
+    template <typename Type>
+    constexpr std::size_t operator()(const std::span<const Type> values) const noexcept {
+      if constexpr (range_kernel_type_v<Type>)
+      {
+        if (!std::is_constant_evaluated() && range_bound_representable<Type>(low) &&
+            range_bound_representable<Type>(high))
+        {
+          return find_out_of_range(values, static_cast<Type>(low), static_cast<Type>(high));
+        }
+      }
+      const auto data = values.data();
+      const auto first = low;
+      const auto last = high;
+      return find_first_failure(0, values.size(), [data, first, last](const std::size_t i) {
+        return !range_less(data[i], first) & range_less(data[i], last);
+      });
+    }
+  };
+
+  /**
+   * @brief A range search for the first element that is less than its predecessor.
+   */
+  struct sorted_search final {
+    template <typename Type>
+    constexpr std::size_t operator()(const std::span<const Type> values) const noexcept {
+      if constexpr (range_kernel_type_v<Type>)
+      {
+        if (!std::is_constant_evaluated())
+        {
+          return find_unsorted(values);
+        }
+      }
+      if (values.size() < 2)
+      {
+        return values.size();
+      }
+      const auto data = values.data();
+      return find_first_failure(1, values.size(), [data](const std::size_t i) {
+        return !(data[i] < data[i - 1]);
+      });
+    }
+  };
+
+  /**
+   * @brief Determine whether every element of a range passes a search.
+   * @param values The range to search.
+   * @param search The search to apply.
+   * @return True if the search found no failing element. Otherwise, false.
+   */
+  template <typename Type, typename Search>
+  constexpr bool range_satisfies(const std::span<const Type> values, const Search& search) noexcept {
+    return search(values) == values.size();
+  }
+
+  /**
+   * @brief Create the diagnostic message format of a range assertion.
+   * @tparam Type The element type of the range.
+   * @return A NUL-terminated "printf"-style format (e.g., `index %zu is %lld`).
+   */
+  template <typename Type>
+  consteval auto make_range_format() noexcept {
+    constexpr auto prefix = std::string_view{ "index %zu is " };
+    constexpr auto value = printf_operand_format<Type>();
+    auto result = std::array<char, prefix.size() + value.size() + 1>{ };
+    std::char_traits<char>::copy(result.data(), prefix.data(), prefix.size());
+    std::char_traits<char>::copy(result.data() + prefix.size(), value.data(), value.size());
+    return result;
+  }
+
+  /**
+   * @brief The diagnostic message format of a range assertion.
+   * @tparam Type The element type of the range.
+   */
+  template <typename Type>
+  inline constexpr auto range_format = make_range_format<Type>();
+
+  /**
+   * @brief Render the first failing element of a range, emit it along with the failing expression, and abort the
+   *        program.
+   * @details The site's format **MUST** be the matching range_format.
+   * @tparam Type The element type of the range.
+   * @param site The site of the failing assertion.
+   * @param index The index of the failing element.
+   * @param value The failing element.
+   */
+  template <typename Type>
+  [[noreturn]] MEGATECH_ASSERTIONS_COLD
+  void dispatch_range_failure(const assertion_site& site, const std::size_t index,
+                              const comparison_operand_t<Type> value) noexcept {
+    dispatch_comparison_failure_printf(site, printf_arguments{ index }, printf_operand(value));
+  }
+
+}
+/// @endcond
+
+namespace megatech {
+
+  /**
+   * @brief Process a range assertion.
+   * @details The search is performed inline, or by one of the library's kernels. Nothing is rendered unless an
+   *          element fails.
+   * @tparam Type The element type of the range.
+   * @tparam Search The type of the search.
+   * @param site The site of the assertion. The site's format **MUST** be the range format for `Type`.
+   * @param values The range to check.
+   * @param search The search to apply to the range.
+   */
+  template <typename Type, typename Search>
+  MEGATECH_ASSERTIONS_INLINE
+  void debug_assertion_range(const assertion_site& site, const std::span<const Type> values,
+                             const Search& search) noexcept {
+    const auto index = search(values);
+    if (index != values.size()) [[unlikely]]
+    {
+      internal::base::dispatch_range_failure<Type>(site, index, values[index]);
+    }
+  }
+
+}
+
+#endif
@@ -0,0 +1,1126 @@
+/**
+ * @file slim.hpp
+ * @brief Run-Time Assertions without `<format>`
+ * @details This provides everything in `megatech/assertions.hpp` except for "format"-style assertions. It never
+ *          includes `<format>`, so translation units that only use ::MEGATECH_ASSERT, the "printf"-style macros, and
+ *          the comparison macros don't pay to parse it. Comparison operands are always rendered with the "printf"-style
+ *          syntax.
+ *
+ *          Unless a client defines ::MEGATECH_ASSERTIONS_DEFAULT_FORMATTER_FORMAT, the default formatter is "printf".
+ *          "format"-style assertions can be added later by including `megatech/assertions/format.hpp`. The default
+ *          formatter is fixed by the first assertion header that is included.
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2024
+ */
+#ifndef MEGATECH_ASSERTIONS_SLIM_HPP
+#define MEGATECH_ASSERTIONS_SLIM_HPP
+
+#include <megatech/assertions/macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <initializer_list>
+#include <source_location>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/// @cond
+// Profiled time is measured with the time stamp counter where there is one.
+#ifdef MEGATECH_ASSERTIONS_PROFILE_CYCLES
+  #if defined(__i386__) || defined(__x86_64__)
+    #define MEGATECH_ASSERTIONS_CYCLE_COUNTER_AVAILABLE (1)
+
+    #include <x86intrin.h>
+  #else
+    #include <chrono>
+  #endif
+#endif
+/// @endcond
+
+namespace megatech {
+
+  /**
+   * @brief The failure counter of a soft assertion.
+   * @details Every counter occupies a separate cache line, so that failing soft assertions on different threads don't
+   *          interfere with each other.
+   */
+  struct alignas(64) soft_assertion_counter final {
+    /**
+     * @brief The number of times the assertion has failed.
+     */
+    std::atomic<std::uint_least64_t> failures{ };
+  };
+
+  /**
+   * @brief A description of the location and contents of an assertion.
+   * @details Every assertion macro expansion creates exactly one site. When
+   *          ::MEGATECH_ASSERTIONS_STATIC_SITES_AVAILABLE is defined, sites are `static constexpr` objects and only a
+   *          single pointer to the site is passed when an assertion fails.
+   */
+  struct assertion_site final {
+    /**
+     * @brief The name of the file containing the assertion. This is a NUL-terminated string.
+     */
+    const char* file_name{ };
+
+    /**
+     * @brief The line number of the assertion.
+     */
+    std::uint_least32_t line{ };
+
+    /**
+     * @brief The name of the function containing the assertion. This is a NUL-terminated string.
+     */
+    const char* function_name{ };
+
+    /**
+     * @brief A textual representation of the assertion's expression. This can be `nullptr`. If it is not `nullptr`,
+     *        it **MUST** be a NUL-terminated string.
+     */
+    const char* expression{ };
+
+    /**
+     * @brief The format of the diagnostic message associated with the assertion. This can be `nullptr`. If it is not
+     *        `nullptr`, it **MUST** be a NUL-terminated string.
+     */
+    const char* format{ };
+
+    /**
+     * @brief The failure counter of a soft assertion. This is `nullptr` for every other kind of assertion.
+     */
+    soft_assertion_counter* counter{ };
+
+    /**
+     * @brief Whether or not the assertion is enabled.
+     * @details This is only checked when ::MEGATECH_ASSERTIONS_RUNTIME_TOGGLES is defined. Otherwise, it is ignored.
+     *          It is safe to modify this from any thread, even though sites are usually `const`.
+     * @see megatech::set_assertions_enabled()
+     */
+    mutable std::atomic<bool> enabled{ true };
+
+    /**
+     * @brief The ID of a compact site.
+     * @details This is only set when ::MEGATECH_ASSERTIONS_COMPACT_SITES is defined. In that case, the file name,
+     *          function name, and expression are all `nullptr`. Otherwise, it is 0.
+     */
+    std::uint_least32_t id{ };
+  };
+
+  /**
+   * @brief The maximum number of context scopes recorded on each thread. Deeper scopes are counted, but not recorded.
+   */
+  constexpr std::size_t assertion_context_capacity{ 16 };
+
+  /**
+   * @brief An unformatted description of a scope created with ::MEGATECH_ASSERT_CONTEXT.
+   */
+  struct assertion_context final {
+    /**
+     * @brief The "format"-style format of the description.
+     */
+    std::string_view format{ };
+
+    /**
+     * @brief A deferred argument encoding of the description's arguments.
+     */
+    const std::byte* arguments{ };
+
+    /**
+     * @brief The size of the encoding in bytes.
+     */
+    std::size_t size{ };
+  };
+
+  /**
+   * @brief A description of a single assertion failure.
+   * @details Failures are passed to the current megatech::assertion_failure_handler. Every pointer is only valid
+   *          until the handler returns.
+   */
+  struct assertion_failure final {
+    /**
+     * @brief The site of the failing assertion. This is never `nullptr`.
+     */
+    const assertion_site* site{ };
+
+    /**
+     * @brief The rendered diagnostic message. This is `nullptr` if the assertion has no message.
+     */
+    const char* message{ };
+
+    /**
+     * @brief A description of an error that occurred while processing the failure. This is `nullptr` if no error
+     *        occurred. If it is not `nullptr`, the message is always `nullptr`.
+     */
+    const char* error{ };
+
+    /**
+     * @brief Whether or not the failing assertion is a soft assertion. If this is false, the program will abort after
+     *        the handler returns.
+     */
+    bool soft{ };
+
+    /**
+     * @brief The return addresses of the failing thread's call stack, innermost first. This is `nullptr` unless the
+     *        library was built with backtraces enabled. The addresses are raw program counters, and they're never
+     *        symbolized before the handler is called.
+     */
+    const void* const* backtrace{ };
+
+    /**
+     * @brief The number of return addresses in the backtrace.
+     */
+    std::size_t backtrace_size{ };
+
+    /**
+     * @brief The failing thread's context scopes, outermost first. This is `nullptr` if the failure is reported on
+     *        another thread (e.g., by the soft assertion reporter).
+     */
+    const assertion_context* const* contexts{ };
+
+    /**
+     * @brief The number of context scopes that were active on the failing thread. Only the first
+     *        megatech::assertion_context_capacity scopes are recorded.
+     */
+    std::size_t context_depth{ };
+  };
+
+  /**
+   * @brief A function that reports assertion failures.
+   * @details Handlers may be called from several threads at once, and they may be called from signal handlers.
+   *          Handlers **MUST NOT** throw. Hard assertion failures abort the program after the handler returns.
+   */
+  using assertion_failure_handler = void (*)(const assertion_failure& failure) noexcept;
+
+  /**
+   * @brief The evaluation profile of one assertion site on one thread.
+   * @details Profiles are only created when ::MEGATECH_ASSERTIONS_PROFILING is defined. Every profile occupies a
+   *          separate cache line and is only written by the thread that claimed it. Profiles are never destroyed, so
+   *          the profiles of threads that have exited are still reported.
+   */
+  struct alignas(64) assertion_profile final {
+    /**
+     * @brief The profiled site. This is `nullptr` only if the profile couldn't be allocated.
+     */
+    const assertion_site* site{ };
+
+    /**
+     * @brief The number of times that the site was evaluated.
+     */
+    std::atomic<std::uint_least64_t> evaluations{ };
+
+    /**
+     * @brief The time spent evaluating the site. This is always 0 unless ::MEGATECH_ASSERTIONS_PROFILE_CYCLES is
+     *        defined.
+     */
+    std::atomic<std::uint_least64_t> cycles{ };
+
+    /**
+     * @brief The next profile in the list of every profile. This is `nullptr` for the last profile.
+     */
+    const assertion_profile* next{ };
+  };
+
+}
+
+/// @cond INTERNAL
+#ifdef MEGATECH_ASSERTIONS_SITE_REGISTRY_AVAILABLE
+extern "C" {
+
+  // The linker defines these symbols to bound the "megatech_assertion_sites" section of each module. If a module
+  // contains no sites, they're undefined and, since they're weak, they resolve to nullptr.
+  [[gnu::weak, gnu::visibility("hidden")]] extern const megatech::assertion_site __start_megatech_assertion_sites[];
+  [[gnu::weak, gnu::visibility("hidden")]] extern const megatech::assertion_site __stop_megatech_assertion_sites[];
+
+}
+#endif
+/// @endcond
+/// @cond INTERNAL
+namespace megatech::internal::base {
+
+  /**
+   * @brief A per-thread stack of context scopes.
+   */
+  struct assertion_context_stack final {
+    std::array<const assertion_context*, assertion_context_capacity> entries{ };
+    std::size_t depth{ };
+  };
+
+  /**
+   * @brief The context scopes of the calling thread. This is constant-initialized, so accessing it never requires a
+   *        guard.
+   */
+  inline thread_local assertion_context_stack pt_assertion_contexts{ };
+
+  /**
+   * @brief The fixed-size header of an entry in the `megatech_assertion_symbols` section.
+   * @details Each header is immediately followed by the NUL-terminated file name, function name, and expression of
+   *          the site. Every size includes the NUL terminator. Entries are padded to a multiple of 4 bytes.
+   */
+  struct compact_site_symbol_header final {
+    std::uint32_t id;
+    std::uint32_t line;
+    std::uint32_t file_name_size;
+    std::uint32_t function_name_size;
+    std::uint32_t expression_size;
+  };
+
+  /**
+   * @brief A complete entry in the `megatech_assertion_symbols` section.
+   * @tparam FileNameSize The size of the file name including its NUL terminator.
+   * @tparam FunctionNameSize The size of the function name including its NUL terminator.
+   * @tparam ExpressionSize The size of the expression including its NUL terminator.
+   */
+  template <std::size_t FileNameSize, std::size_t FunctionNameSize, std::size_t ExpressionSize>
+  struct compact_site_symbol final {
+    compact_site_symbol_header header;
+    char file_name[FileNameSize];
+    char function_name[FunctionNameSize];
+    char expression[ExpressionSize];
+  };
+
+  /**
+   * @brief Compute the ID of a compact site.
+   * @details This is the 32-bit FNV-1a hash of the site's file name, line, function name, and expression. It is only
+   *          ever computed at compile-time.
+   * @param file_name The name of the file containing the assertion.
+   * @param line The line number of the assertion.
+   * @param function_name The name of the function containing the assertion.
+   * @param expression A textual representation of the assertion's expression.
+   * @return The ID of the site.
+   */
+  consteval std::uint32_t compact_site_id(const char* file_name, const std::uint32_t line, const char* function_name,
+                                          const char* expression) noexcept {
+    auto hash = std::uint32_t{ 2166136261 };
+    const auto mix = [&hash](const unsigned char byte) {
+      hash = (hash ^ byte) * std::uint32_t{ 16777619 };
+    };
+    for (const auto string : { file_name, function_name, expression })
+    {
+      for (auto current = string; *current; ++current)
+      {
+        mix(static_cast<unsigned char>(*current));
+      }
+      mix(0);
+    }
+    for (auto shift = 0; shift < 32; shift += 8)
+    {
+      mix(static_cast<unsigned char>(line >> shift));
+    }
+    return hash;
+  }
+
+  /**
+   * @brief Create an entry for the `megatech_assertion_symbols` section.
+   * @tparam FileNameSize The size of the file name including its NUL terminator.
+   * @tparam FunctionNameSize The size of the function name including its NUL terminator.
+   * @tparam ExpressionSize The size of the expression including its NUL terminator.
+   * @param id The ID of the site.
+   * @param line The line number of the assertion.
+   * @param file_name The name of the file containing the assertion.
+   * @param function_name The name of the function containing the assertion.
+   * @param expression A textual representation of the assertion's expression.
+   * @return The new entry.
+   */
+  template <std::size_t FileNameSize, std::size_t FunctionNameSize, std::size_t ExpressionSize>
+  consteval compact_site_symbol<FileNameSize, FunctionNameSize, ExpressionSize>
+  make_compact_site_symbol(const std::uint32_t id, const std::uint32_t line, const char* file_name,
+                           const char* function_name, const char* expression) noexcept {
+    auto result = compact_site_symbol<FileNameSize, FunctionNameSize, ExpressionSize>{
+      { id, line, FileNameSize, FunctionNameSize, ExpressionSize }, { }, { }, { }
+    };
+    std::char_traits<char>::copy(result.file_name, file_name, FileNameSize);
+    std::char_traits<char>::copy(result.function_name, function_name, FunctionNameSize);
+    std::char_traits<char>::copy(result.expression, expression, ExpressionSize);
+    return result;
+  }
+
+  /**
+   * @brief Compute the length of a NUL-terminated string at compile-time.
+   * @param string The string.
+   * @return The number of characters before the NUL terminator.
+   */
+  consteval std::size_t string_length(const char* string) noexcept {
+    return std::char_traits<char>::length(string);
+  }
+
+  /**
+   * @brief Determine whether or not a site is enabled by a run-time toggle.
+   * @param site The site to check.
+   * @return True if the site is enabled. Otherwise, false.
+   */
+  MEGATECH_ASSERTIONS_INLINE
+  bool assertion_site_enabled(const assertion_site& site) noexcept {
+    return site.enabled.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Emit a diagnostic message containing the failing expression and abort the program.
+   * @details This function is thread-safe. This means that when an assertion failure occurs on a second thread, while
+   *          processing an assertion on the initial thread, both assertion messages will be collected and output
+   *          before aborting the program. It never locks, and on POSIX systems it is async-signal-safe.
+   * @param site The site of the failing assertion.
+   */
+  [[noreturn]] MEGATECH_ASSERTIONS_COLD
+  void dispatch_assertion_failure(const assertion_site& site) noexcept;
+
+  /**
+   * @brief Emit a diagnostic message containing the failing expression and abort the program.
+   * @details This function is thread-safe. This means that when an assertion failure occurs on a second thread, while
+   *          processing an assertion on the initial thread, both assertion messages will be collected and output
+   *          before aborting the program. It never locks, and on POSIX systems it is async-signal-safe.
+   * @param site The site of the failing assertion.
+   * @param message A message to output explaining the assertion failure. This can be `nullptr`. If it is not
+   *                `nullptr`, it must be a NUL-terminated string.
+   */
+  [[noreturn]] MEGATECH_ASSERTIONS_COLD
+  void dispatch_assertion_failure_with_message(const assertion_site& site, const char* message) noexcept;
+
+  /**
+   * @brief Attempt to recover from an error during an assertion failure.
+   * @details This is called whenever an error occurs while processing a failed assertion. Some errors are probably
+   *          unrecoverable, but this still attempts to write as much information as it can to standard error. This
+   *          function is not thread-safe. That means that it will not attempt to collect assertion failures occurring
+   *          in parallel. Instead, it simply writes to standard error and immediately aborts the program.
+   * @param site The site of the failing assertion.
+   * @param error An error message explaining what kind of error occurred. This can be `nullptr`. If it is not
+   *             `nullptr`, it must be a NUL-terminated string.
+   */
+  [[noreturn]] MEGATECH_ASSERTIONS_COLD
+  void dispatch_assertion_failure_with_error(const assertion_site& site, const char* error) noexcept;
+
+  /**
+   * @brief Render a "printf"-style diagnostic message, emit it along with the failing expression, and abort the
+   *        program.
+   * @details The site is passed by pointer because `va_start` can't be used with a reference parameter.
+   * @param site The site of the failing assertion. The site's format is used to render the diagnostic message. This
+   *             **MUST NOT** be `nullptr`.
+   * @param ... 0 or more formatting arguments to use when rendering the diagnostic message.
+   */
+  [[noreturn]] MEGATECH_ASSERTIONS_COLD
+  void dispatch_assertion_failure_printf(const assertion_site* site, ...) noexcept;
+
+  /**
+   * @brief Create a new profile for a site on the calling thread and add it to the list of every profile.
+   * @details The first call also arranges for megatech::write_assertion_profile() to be called at exit.
+   * @param site The site to profile.
+   * @return A pointer to the new profile. If the profile can't be allocated, this is a per-thread profile that isn't
+   *         listed. It is never `nullptr`.
+   */
+  MEGATECH_ASSERTIONS_COLD
+  assertion_profile* claim_assertion_profile(const assertion_site& site) noexcept;
+
+  /**
+   * @brief Read the clock used to measure profiled assertions.
+   * @return The current value of the clock.
+   */
+  MEGATECH_ASSERTIONS_INLINE
+  std::uint_least64_t read_profile_clock() noexcept {
+#if defined(MEGATECH_ASSERTIONS_CYCLE_COUNTER_AVAILABLE)
+    return __rdtsc();
+#elif defined(MEGATECH_ASSERTIONS_PROFILE_CYCLES)
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#else
+    return 0;
+#endif
+  }
+
+  /**
+   * @brief Count an evaluation of a profiled site.
+   * @details Only the owning thread writes to a profile, so a relaxed load and store is enough. No atomic
+   *          read-modify-write is required.
+   * @param profile The calling thread's profile of the site.
+   * @return The time that the evaluation began.
+   */
+  MEGATECH_ASSERTIONS_INLINE
+  std::uint_least64_t begin_assertion_profile(assertion_profile& profile) noexcept {
+    profile.evaluations.store(profile.evaluations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return read_profile_clock();
+  }
+
+  /**
+   * @brief Record the time spent evaluating a profiled site.
+   * @param profile The calling thread's profile of the site.
+   * @param start The time that the evaluation began.
+   */
+  MEGATECH_ASSERTIONS_INLINE
+  void end_assertion_profile([[maybe_unused]] assertion_profile& profile,
+                             [[maybe_unused]] const std::uint_least64_t start) noexcept {
+#ifdef MEGATECH_ASSERTIONS_PROFILE_CYCLES
+    const auto elapsed = read_profile_clock() - start;
+    profile.cycles.store(profile.cycles.load(std::memory_order_relaxed) + elapsed, std::memory_order_relaxed);
+#endif
+  }
+
+  /**
+   * @brief Count a soft assertion failure and emit a diagnostic message containing the failing expression.
+   * @details The diagnostic is only emitted if the site's report limit hasn't been reached. This never locks and it
+   *          never aborts the program.
+   * @param site The site of the failing soft assertion.
+   */
+  MEGATECH_ASSERTIONS_COLD
+  void dispatch_soft_assertion_failure(const assertion_site& site) noexcept;
+
+  /**
+   * @brief Count a soft assertion failure and emit a "printf"-style diagnostic message.
+   * @param site A pointer to the site of the failing soft assertion. The site's format is used to render the
+   *             diagnostic message. This **MUST NOT** be `nullptr`.
+   * @param ... 0 or more formatting arguments to use when rendering the diagnostic message.
+   * @see dispatch_soft_assertion_failure()
+   */
+  MEGATECH_ASSERTIONS_COLD
+  void dispatch_soft_assertion_failure_printf(const assertion_site* site, ...) noexcept;
+
+  /**
+   * @brief Report an assertion failure during constant evaluation.
+   * @details This is intentionally not `constexpr`. Calling it during constant evaluation makes the enclosing
+   *          expression non-constant, so the compiler reports the failure (and the expression) as an error. It is
+   *          never called at run-time.
+   * @param expression The failing assertion's expression.
+   */
+  inline void assertion_failed_during_constant_evaluation(const char* expression) noexcept {
+    static_cast<void>(expression);
+  }
+
+  /**
+   * @brief Process an assertion during constant evaluation.
+   * @param condition Whether or not the assertion passed. If this is false, constant evaluation fails.
+   * @param expression The assertion's expression.
+   */
+  constexpr void constant_evaluated_assertion(const bool condition, const char* expression) noexcept {
+    if (!condition)
+    {
+      assertion_failed_during_constant_evaluation(expression);
+    }
+  }
+
+  /**
+   * @brief Whether or not an assertion category is enabled by a category mask.
+   * @tparam Category The category. This **MUST** have an integral or enumeration type.
+   * @tparam Mask The enabled categories.
+   */
+  template <auto Category, std::uint_least64_t Mask>
+  requires std::is_integral_v<decltype(Category)> || std::is_enum_v<decltype(Category)>
+  inline constexpr bool assertion_category_enabled = (static_cast<std::uint_least64_t>(Category) & Mask) != 0;
+
+  /**
+   * @brief Advance a sampling countdown and determine whether the current pass should be checked.
+   * @param countdown A per-thread, per-site counter.
+   * @param n The sampling period. If this is 0 or 1, every pass is checked.
+   * @return True if the current pass should be checked. Otherwise, false.
+   */
+  template <typename Type>
+  MEGATECH_ASSERTIONS_INLINE
+  bool sample_assertion(std::uint_least32_t& countdown, const Type n) noexcept {
+    const auto period = static_cast<std::uint_least32_t>(n);
+    // With a constant period this test disappears, and powers of two reduce to an increment and a mask.
+    if (std::has_single_bit(period))
+    {
+      return !(countdown++ & (period - 1));
+    }
+    if (!countdown)
+    {
+      countdown = period ? period - 1 : 0;
+      return true;
+    }
+    --countdown;
+    return false;
+  }
+
+  /**
+   * @brief A transparent `==` comparison.
+   * @details The comparison macros name these function objects instead of the ones from `<functional>`, which is
+   *          too expensive to include in every translation unit that asserts something.
+   */
+  struct equal_to final {
+    template <typename Left, typename Right>
+    constexpr bool operator()(const Left& left, const Right& right) const {
+      return left == right;
+    }
+  };
+
+  /**
+   * @brief A transparent `!=` comparison.
+   */
+  struct not_equal_to final {
+    template <typename Left, typename Right>
+    constexpr bool operator()(const Left& left, const Right& right) const {
+      return left != right;
+    }
+  };
+
+  /**
+   * @brief A transparent `<` comparison.
+   */
+  struct less final {
+    template <typename Left, typename Right>
+    constexpr bool operator()(const Left& left, const Right& right) const {
+      return left < right;
+    }
+  };
+
+  /**
+   * @brief A transparent `<=` comparison.
+   */
+  struct less_equal final {
+    template <typename Left, typename Right>
+    constexpr bool operator()(const Left& left, const Right& right) const {
+      return left <= right;
+    }
+  };
+
+  /**
+   * @brief A transparent `>` comparison.
+   */
+  struct greater final {
+    template <typename Left, typename Right>
+    constexpr bool operator()(const Left& left, const Right& right) const {
+      return left > right;
+    }
+  };
+
+  /**
+   * @brief A transparent `>=` comparison.
+   */
+  struct greater_equal final {
+    template <typename Left, typename Right>
+    constexpr bool operator()(const Left& left, const Right& right) const {
+      return left >= right;
+    }
+  };
+
+  /**
+   * @brief Retrieve the textual operator of a comparison function object.
+   * @tparam Compare One of the comparison function objects above (e.g., equal_to).
+   * @return The operator.
+   */
+  template <typename Compare>
+  consteval std::string_view comparison_operator() noexcept {
+    if constexpr (std::is_same_v<Compare, equal_to>)
+    {
+      return "==";
+    }
+    else if constexpr (std::is_same_v<Compare, not_equal_to>)
+    {
+      return "!=";
+    }
+    else if constexpr (std::is_same_v<Compare, less>)
+    {
+      return "<";
+    }
+    else if constexpr (std::is_same_v<Compare, less_equal>)
+    {
+      return "<=";
+    }
+    else if constexpr (std::is_same_v<Compare, greater>)
+    {
+      return ">";
+    }
+    else
+    {
+      static_assert(std::is_same_v<Compare, greater_equal>, "Unsupported comparison.");
+      return ">=";
+    }
+  }
+
+  /**
+   * @brief Determine whether both operands of a failing comparison are rendered with the "format"-style syntax.
+   * @details This is always false unless `Format` is true. `megatech/assertions/format.hpp` specializes it for that
+   *          case.
+   * @tparam Format Whether or not the comparison was compiled with "format"-style assertions available.
+   * @tparam Left The type of the left operand.
+   * @tparam Right The type of the right operand.
+   */
+  template <bool Format, typename Left, typename Right>
+  constexpr bool format_comparison_v = false;
+
+  /**
+   * @brief Retrieve the "printf"-style conversion used to render a comparison operand.
+   * @tparam Type The type of the operand.
+   * @return The conversion. Operands that can't be rendered use a fixed placeholder instead.
+   */
+  template <typename Type>
+  consteval std::string_view printf_operand_format() noexcept {
+    using value_type = std::decay_t<Type>;
+    if constexpr (std::is_same_v<value_type, bool> || std::is_same_v<value_type, const char*> ||
+                  std::is_same_v<value_type, char*>)
+    {
+      return "%s";
+    }
+    else if constexpr (std::is_same_v<value_type, char>)
+    {
+      return "%c";
+    }
+    else if constexpr (std::is_enum_v<value_type>)
+    {
+      return printf_operand_format<std::underlying_type_t<value_type>>();
+    }
+    else if constexpr (std::is_integral_v<value_type> && std::is_signed_v<value_type>)
+    {
+      return "%lld";
+    }
+    else if constexpr (std::is_integral_v<value_type>)
+    {
+      return "%llu";
+    }
+    else if constexpr (std::is_same_v<value_type, long double>)
+    {
+      return "%.21Lg";
+    }
+    else if constexpr (std::is_same_v<value_type, float>)
+    {
+      return "%.9g";
+    }
+    else if constexpr (std::is_floating_point_v<value_type>)
+    {
+      return "%.17g";
+    }
+    else if constexpr ((std::is_pointer_v<value_type> && !std::is_function_v<std::remove_pointer_t<value_type>>) ||
+                       std::is_null_pointer_v<value_type>)
+    {
+      return "%p";
+    }
+    // Pointers are handled first, since null pointers are also convertible to std::string_view.
+    else if constexpr (std::is_convertible_v<const value_type&, std::string_view>)
+    {
+      return "%.*s";
+    }
+    else
+    {
+      return "(unformattable)";
+    }
+  }
+
+  /**
+   * @brief A single "printf"-style argument in a printf_argument_pack.
+   * @tparam Index The position of the argument in its pack.
+   * @tparam Type The type of the argument.
+   */
+  template <std::size_t Index, typename Type>
+  struct printf_argument {
+    Type value;
+  };
+
+  /**
+   * @brief A fixed list of "printf"-style arguments.
+   * @details This is a minimal stand-in for `std::tuple`. Each argument is stored in a base distinguished by its
+   *          index, so an argument is retrieved by converting the pack to that base.
+   * @tparam Indices A `std::index_sequence` of the positions of the arguments.
+   * @tparam Types The types of the arguments.
+   */
+  template <typename Indices, typename... Types>
+  struct printf_argument_pack;
+
+  template <std::size_t... Indices, typename... Types>
+  struct printf_argument_pack<std::index_sequence<Indices...>, Types...> : printf_argument<Indices, Types>... {
+    constexpr explicit printf_argument_pack(const Types... values) noexcept :
+    printf_argument<Indices, Types>{ values }... { }
+  };
+
+  /**
+   * @brief A printf_argument_pack indexed in declaration order.
+   * @tparam Types The types of the arguments.
+   */
+  template <typename... Types>
+  struct printf_arguments final : printf_argument_pack<std::index_sequence_for<Types...>, Types...> {
+    using printf_argument_pack<std::index_sequence_for<Types...>, Types...>::printf_argument_pack;
+  };
+
+  template <typename... Types>
+  printf_arguments(Types...) -> printf_arguments<Types...>;
+
+  /**
+   * @brief Convert a comparison operand into the "printf"-style arguments matching printf_operand_format().
+   * @tparam Type The type of the operand.
+   * @param value The operand.
+   * @return A printf_arguments of 0 or more arguments.
+   */
+  template <typename Type>
+  auto printf_operand(const Type& value) noexcept {
+    using value_type = std::decay_t<Type>;
+    if constexpr (std::is_same_v<value_type, bool>)
+    {
+      return printf_arguments{ value ? "true" : "false" };
+    }
+    else if constexpr (std::is_same_v<value_type, const char*> || std::is_same_v<value_type, char*>)
+    {
+      const auto string = static_cast<const char*>(value);
+      return printf_arguments{ string ? string : "(null)" };
+    }
+    else if constexpr (std::is_same_v<value_type, char>)
+    {
+      return printf_arguments{ static_cast<int>(value) };
+    }
+    else if constexpr (std::is_enum_v<value_type>)
+    {
+      return printf_operand(static_cast<std::underlying_type_t<value_type>>(value));
+    }
+    else if constexpr (std::is_integral_v<value_type> && std::is_signed_v<value_type>)
+    {
+      return printf_arguments{ static_cast<long long>(value) };
+    }
+    else if constexpr (std::is_integral_v<value_type>)
+    {
+      return printf_arguments{ static_cast<unsigned long long>(value) };
+    }
+    else if constexpr (std::is_same_v<value_type, long double>)
+    {
+      return printf_arguments{ value };
+    }
+    else if constexpr (std::is_floating_point_v<value_type>)
+    {
+      return printf_arguments{ static_cast<double>(value) };
+    }
+    else if constexpr ((std::is_pointer_v<value_type> && !std::is_function_v<std::remove_pointer_t<value_type>>) ||
+                       std::is_null_pointer_v<value_type>)
+    {
+      return printf_arguments{ static_cast<const void*>(value) };
+    }
+    else if constexpr (std::is_convertible_v<const value_type&, std::string_view>)
+    {
+      const auto view = static_cast<std::string_view>(value);
+      return printf_arguments{ static_cast<int>(view.size()), view.data() };
+    }
+    else
+    {
+      return printf_arguments<>{ };
+    }
+  }
+
+  /**
+   * @brief Create the diagnostic message format of a comparison.
+   * @tparam Compare The comparison function object.
+   * @tparam Format Whether or not the comparison was compiled with "format"-style assertions available.
+   * @tparam Left The type of the left operand.
+   * @tparam Right The type of the right operand.
+   * @return A NUL-terminated format (e.g., `{} == {}` or `%lld == %lld`).
+   */
+  template <typename Compare, bool Format, typename Left, typename Right>
+  consteval auto make_comparison_format() noexcept {
+    constexpr auto formatted = format_comparison_v<Format, Left, Right>;
+    constexpr auto left = formatted ? std::string_view{ "{}" } : printf_operand_format<Left>();
+    constexpr auto op = comparison_operator<Compare>();
+    constexpr auto right = formatted ? std::string_view{ "{}" } : printf_operand_format<Right>();
+    auto result = std::array<char, left.size() + op.size() + right.size() + 3>{ };
+    auto position = result.data();
+    const auto parts = std::array<std::string_view, 5>{ left, " ", op, " ", right };
+    for (const auto part : parts)
+    {
+      std::char_traits<char>::copy(position, part.data(), part.size());
+      position += part.size();
+    }
+    return result;
+  }
+
+  /**
+   * @brief The diagnostic message format of a comparison.
+   * @details This is a variable so that every comparison of the same types shares one string with static storage
+   *          duration.
+   * @tparam Compare The comparison function object.
+   * @tparam Format Whether or not the comparison was compiled with "format"-style assertions available.
+   * @tparam Left The type of the left operand.
+   * @tparam Right The type of the right operand.
+   */
+  template <typename Compare, bool Format, typename Left, typename Right>
+  inline constexpr auto comparison_format = make_comparison_format<Compare, Format, Left, Right>();
+
+  /**
+   * @brief The type used to pass a comparison operand to the failure path.
+   * @details Scalars are passed by value so that a passing comparison never has to spill its operands to memory.
+   *          Every other type is passed by reference.
+   * @tparam Type The type of the operand.
+   */
+  template <typename Type>
+  using comparison_operand_t = std::conditional_t<std::is_scalar_v<Type>, Type, const Type&>;
+
+  /**
+   * @brief Render a "printf"-style comparison failure from two packs of converted operands.
+   * @param site The site of the failing assertion.
+   * @param left The arguments converted from the left operand.
+   * @param right The arguments converted from the right operand.
+   */
+  template <std::size_t... LeftIndices, typename... Left, std::size_t... RightIndices, typename... Right>
+  [[noreturn]] MEGATECH_ASSERTIONS_COLD
+  void dispatch_comparison_failure_printf(const assertion_site& site,
+                                          const printf_argument_pack<std::index_sequence<LeftIndices...>, Left...>& left,
+                                          const printf_argument_pack<std::index_sequence<RightIndices...>, Right...>& right)
+                                          noexcept {
+    dispatch_assertion_failure_printf(&site, static_cast<const printf_argument<LeftIndices, Left>&>(left).value...,
+                                      static_cast<const printf_argument<RightIndices, Right>&>(right).value...);
+  }
+
+  /**
+   * @brief Render the operands of a failing comparison with the "format"-style syntax, emit them along with the failing
+   *        expression, and abort the program.
+   * @details This is defined by `megatech/assertions/format.hpp`. It's only ever instantiated when format_comparison_v
+   *          is true.
+   * @tparam Left The type of the left operand.
+   * @tparam Right The type of the right operand.
+   * @param site The site of the failing assertion.
+   * @param left The left operand.
+   * @param right The right operand.
+   */
+  template <typename Left, typename Right>
+  [[noreturn]] MEGATECH_ASSERTIONS_COLD
+  void dispatch_comparison_failure_format(const assertion_site& site, const comparison_operand_t<Left> left,
+                                          const comparison_operand_t<Right> right) noexcept;
+
+  /**
+   * @brief Render the operands of a failing comparison, emit them along with the failing expression, and abort the
+   *        program.
+   * @details The site's format **MUST** be the matching comparison_format.
+   * @tparam Format Whether or not the comparison was compiled with "format"-style assertions available.
+   * @tparam Left The type of the left operand.
+   * @tparam Right The type of the right operand.
+   * @param site The site of the failing assertion.
+   * @param left The left operand.
+   * @param right The right operand.
+   */
+  template <bool Format, typename Left, typename Right>
+  [[noreturn]] MEGATECH_ASSERTIONS_COLD
+  void dispatch_comparison_failure(const assertion_site& site, const comparison_operand_t<Left> left,
+                                   const comparison_operand_t<Right> right) noexcept {
+    if constexpr (format_comparison_v<Format, Left, Right>)
+    {
+      dispatch_comparison_failure_format<Left, Right>(site, left, right);
+    }
+    else
+    {
+      dispatch_comparison_failure_printf(site, printf_operand(left), printf_operand(right));
+    }
+  }
+
+}
+/// @endcond
+namespace megatech {
+
+  /**
+   * @brief Retrieve every static assertion site in the calling module.
+   * @details Sites are collected by the linker, so this has no start-up or registration cost. Only sites linked into
+   *          the same module (i.e., the same executable or shared library) as the caller are visible. If
+   *          ::MEGATECH_ASSERTIONS_SITE_REGISTRY_AVAILABLE isn't defined, this is always empty.
+   * @return A view of every static assertion site in the calling module. The order of the sites is unspecified.
+   */
+#ifdef MEGATECH_ASSERTIONS_SITE_REGISTRY_AVAILABLE
+  [[gnu::visibility("hidden")]]
+#endif
+  inline std::span<const assertion_site> assertion_sites() noexcept {
+#ifdef MEGATECH_ASSERTIONS_SITE_REGISTRY_AVAILABLE
+    if (!__start_megatech_assertion_sites)
+    {
+      return { };
+    }
+    return { __start_megatech_assertion_sites, __stop_megatech_assertion_sites };
+#else
+    return { };
+#endif
+  }
+
+  /**
+   * @brief Enable or disable every site whose file name or function name matches a pattern.
+   * @details Patterns are globs. `*` matches any sequence of characters and `?` matches any single character. Every
+   *          other character only matches itself. Changes only affect assertions compiled with
+   *          ::MEGATECH_ASSERTIONS_RUNTIME_TOGGLES defined. This is thread-safe.
+   * @param sites The sites to search. Usually, this is the result of megatech::assertion_sites().
+   * @param pattern The pattern to match.
+   * @param enabled Whether matching sites should be enabled or disabled.
+   * @return The number of sites that matched the pattern.
+   */
+  std::size_t set_assertions_enabled(const std::span<const assertion_site> sites, const std::string_view pattern,
+                                     const bool enabled) noexcept;
+
+  /**
+   * @brief Enable or disable sites according to a specification string.
+   * @details A specification is a comma separated list of patterns. Patterns prefixed with `-` disable matching sites.
+   *          Patterns prefixed with `+`, or with no prefix, enable matching sites. Patterns are applied in order, so
+   *          later patterns take precedence (e.g., `-*,+*parser.cpp` disables everything except one file). This is
+   *          also the syntax of the `MEGATECH_ASSERTIONS_TOGGLES` environment variable.
+   * @param sites The sites to configure. Usually, this is the result of megatech::assertion_sites().
+   * @param specification The specification to apply. If this is `nullptr`, nothing happens.
+   * @see megatech::set_assertions_enabled()
+   */
+  void configure_assertions(const std::span<const assertion_site> sites, const char* specification) noexcept;
+
+  /**
+   * @brief Retrieve every assertion profile in the program.
+   * @details Each site has one profile for every thread that evaluated it. Profiles are only created when
+   *          ::MEGATECH_ASSERTIONS_PROFILING is defined. It is safe to read profiles while other threads update them.
+   * @return The most recently claimed profile. Each profile links to the next. If there are no profiles, this is
+   *         `nullptr`.
+   */
+  const assertion_profile* assertion_profiles() noexcept;
+
+  /**
+   * @brief Write a report of every assertion profile to standard error.
+   * @details Profiles of the same site are combined. Sites are sorted by the time spent evaluating them. If no time
+   *          has been measured, they're sorted by the number of evaluations instead. This is called automatically at
+   *          exit when any profile exists. It isn't async-signal-safe.
+   */
+  void write_assertion_profile() noexcept;
+
+  /**
+   * @brief Write an assertion failure to the standard error stream.
+   * @details This is the library's default failure handler. It is async-signal-safe on POSIX systems, except when
+   *          the failure has a backtrace (symbolizing a backtrace uses `dladdr()`). Custom handlers can call this to
+   *          forward failures to standard error.
+   * @param failure The failure to report.
+   */
+  void default_assertion_failure_handler(const assertion_failure& failure) noexcept;
+
+  /**
+   * @brief Replace the function that reports assertion failures.
+   * @details The handler is only read when an assertion fails, so this has no effect on the cost of passing
+   *          assertions. This is thread-safe.
+   * @param handler The new handler. If this is `nullptr`, the default handler is restored.
+   * @return The previous handler.
+   */
+  assertion_failure_handler set_assertion_failure_handler(const assertion_failure_handler handler) noexcept;
+
+  /**
+   * @brief Retrieve the function that reports assertion failures.
+   * @return The current handler. This is never `nullptr`.
+   */
+  assertion_failure_handler get_assertion_failure_handler() noexcept;
+
+  /**
+   * @brief Process an assertion without a formatted message.
+   * @details This is the safest assetion function. It has minimal potential for failure even if a thoroughly broken
+   *          program. The condition is tested inline. Only a failing assertion calls into the library.
+   * @param site The site of the assertion.
+   * @param condition Whether or not the assertion passed. If this is false the program will be aborted with a
+   *                  diagnostic.
+   */
+  MEGATECH_ASSERTIONS_INLINE
+  void debug_assertion(const assertion_site& site, const bool condition) noexcept {
+    if (!condition) [[unlikely]]
+    {
+      internal::base::dispatch_assertion_failure(site);
+    }
+  }
+
+  /**
+   * @brief Process an assertion using the "printf"-style formatting syntax.
+   * @details The condition is tested inline. Only a failing assertion calls into the library. The site's format is
+   *          used to render the diagnostic message.
+   * @tparam Args The types of the formatting arguments.
+   * @param site The site of the assertion.
+   * @param condition Whether or not the assertion passed. If this is false the program will be aborted with a
+   *                  diagnostic.
+   * @param args 0 or more formatting arguments to use when rendering the diagnostic message.
+   */
+  template <typename... Args>
+  MEGATECH_ASSERTIONS_INLINE
+  void debug_assertion_printf(const assertion_site& site, const bool condition, const Args&... args) noexcept {
+    if (!condition) [[unlikely]]
+    {
+      internal::base::dispatch_assertion_failure_printf(&site, args...);
+    }
+  }
+
+  /**
+   * @brief Process a comparison assertion.
+   * @details The comparison is performed inline on the bound operands. Nothing is copied or rendered unless the
+   *          comparison fails.
+   * @tparam Compare The comparison function object (e.g., equal_to).
+   * @tparam Format Whether or not the comparison was compiled with "format"-style assertions available. This **MUST**
+   *                match the site's format.
+   * @tparam Left The type of the left operand.
+   * @tparam Right The type of the right operand.
+   * @param site The site of the assertion. The site's format **MUST** be the format for `Compare`, `Left`, and
+   *             `Right`.
+   * @param left The left operand.
+   * @param right The right operand.
+   */
+  template <typename Compare, bool Format, typename Left, typename Right>
+  MEGATECH_ASSERTIONS_INLINE
+  void debug_assertion_compare(const assertion_site& site, const Left& left, const Right& right) noexcept {
+    if (!Compare{ }(left, right)) [[unlikely]]
+    {
+      internal::base::dispatch_comparison_failure<Format, Left, Right>(site, left, right);
+    }
+  }
+
+  /**
+   * @brief Process a soft assertion without a formatted message.
+   * @details Unlike megatech::debug_assertion(), a failing soft assertion doesn't abort the program.
+   * @param site The site of the soft assertion. The site **MUST** have a counter.
+   * @param condition Whether or not the assertion passed. If this is false the failure is counted.
+   */
+  MEGATECH_ASSERTIONS_INLINE
+  void soft_assertion(const assertion_site& site, const bool condition) noexcept {
+    if (!condition) [[unlikely]]
+    {
+      internal::base::dispatch_soft_assertion_failure(site);
+    }
+  }
+
+  /**
+   * @brief Process a soft assertion using the "printf"-style formatting syntax.
+   * @tparam Args The types of the formatting arguments.
+   * @param site The site of the soft assertion. The site **MUST** have a counter.
+   * @param condition Whether or not the assertion passed. If this is false the failure is counted.
+   * @param args 0 or more formatting arguments to use when rendering the diagnostic message.
+   * @see megatech::soft_assertion()
+   */
+  template <typename... Args>
+  MEGATECH_ASSERTIONS_INLINE
+  void soft_assertion_printf(const assertion_site& site, const bool condition, const Args&... args) noexcept {
+    if (!condition) [[unlikely]]
+    {
+      internal::base::dispatch_soft_assertion_failure_printf(&site, args...);
+    }
+  }
+
+  /**
+   * @brief Retrieve the number of times that a soft assertion has failed.
+   * @param site The site to query.
+   * @return The number of failures counted at the site. If the site isn't a soft assertion site, this is 0.
+   */
+  inline std::uint_least64_t soft_assertion_failures(const assertion_site& site) noexcept {
+    return site.counter ? site.counter->failures.load(std::memory_order_relaxed) : 0;
+  }
+
+  /**
+   * @brief Retrieve the number of soft assertion failures that were dropped because the report queue was full.
+   * @details Dropped failures are still counted by their sites. They just aren't reported.
+   * @return The number of dropped failures. This is always 0 unless the library was built with a soft assertion
+   *         queue.
+   */
+  std::uint_least64_t dropped_soft_assertion_failures() noexcept;
+
+  /**
+   * @brief Wait for every queued soft assertion failure to be reported.
+   * @details This never waits longer than the library's drain timeout. It returns immediately if soft assertion
+   *          failures are reported on the failing thread, or if it's called from a failure handler running on the
+   *          reporter thread.
+   */
+  void flush_soft_assertion_failures() noexcept;
+
+}
+
+/// @cond INTERNAL
+namespace megatech::internal::base {
+
+  /**
+   * @brief Apply the `MEGATECH_ASSERTIONS_TOGGLES` environment variable to a set of sites.
+   * @param sites The sites to configure.
+   */
+  void apply_environment_assertion_toggles(const std::span<const assertion_site> sites) noexcept;
+
+#if defined(MEGATECH_ASSERTIONS_RUNTIME_TOGGLES) && defined(MEGATECH_ASSERTIONS_SITE_REGISTRY_AVAILABLE)
+  // This is initialized once per module, rather than once per site, so the environment is only read a handful of
+  // times during start-up.
+  [[gnu::visibility("hidden")]] inline const bool g_environment_assertion_toggles_applied =
+    (apply_environment_assertion_toggles(assertion_sites()), true);
+#endif
+
+}
+/// @endcond
+#endif
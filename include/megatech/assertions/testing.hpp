@@ -0,0 +1,178 @@
+/**
+ * @file testing.hpp
+ * @brief In-Process Assertion Failure Tests
+ * @details Hard assertion failures normally abort the program, so each failure path needs its own process to be
+ *          tested. The helpers in this file trap hard assertion failures on the calling thread instead. A trapped
+ *          failure is recorded, reported to no one, and then control jumps back to the helper with `std::longjmp()`.
+ *          This allows thousands of failure paths to be tested in a single process.
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2024
+ */
+#ifndef MEGATECH_ASSERTIONS_TESTING_HPP
+#define MEGATECH_ASSERTIONS_TESTING_HPP
+
+#include <megatech/assertions.hpp>
+
+#include <csetjmp>
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <functional>
+#include <string_view>
+#include <utility>
+
+namespace megatech::testing {
+
+  /**
+   * @brief A copy of a trapped hard assertion failure.
+   * @details Everything is copied out of the failing site, so the failure stays valid after the site's frame is gone.
+   *          Strings other than the message point to the same storage as the site's strings.
+   */
+  struct captured_assertion_failure final {
+    /**
+     * @brief The name of the file containing the failing assertion. This is `nullptr` if the site is compact.
+     */
+    const char* file_name{ };
+
+    /**
+     * @brief The line number of the failing assertion.
+     */
+    std::uint_least32_t line{ };
+
+    /**
+     * @brief The name of the function containing the failing assertion. This is `nullptr` if the site is compact.
+     */
+    const char* function_name{ };
+
+    /**
+     * @brief The failing assertion's expression. This is `nullptr` if the site is compact.
+     */
+    const char* expression{ };
+
+    /**
+     * @brief The ID of the failing assertion's site. This is 0 unless the site is compact.
+     */
+    std::uint_least32_t id{ };
+
+    /**
+     * @brief Any error that occurred while processing the failure. This is `nullptr` if no error occurred.
+     */
+    const char* error{ };
+
+    /**
+     * @brief Whether the failure had a rendered diagnostic message.
+     */
+    bool has_message{ };
+
+    /**
+     * @brief The rendered diagnostic message. This is NUL-terminated, and it's truncated to fit.
+     */
+    std::array<char, 1024> message{ };
+  };
+
+}
+
+/// @cond INTERNAL
+namespace megatech::internal::base {
+
+  /**
+   * @brief A per-thread trap for hard assertion failures.
+   * @details Traps form a stack. When a hard assertion fails, the innermost trap is removed from the stack, the
+   *          failure is copied into it, and then its escape is called. The escape **MUST NOT** return. Escaping skips
+   *          the destructors of any context scopes created after the trap was pushed, so the calling thread's context
+   *          depth is restored to its depth at that time first.
+   */
+  struct assertion_failure_trap final {
+    void (*escape)(assertion_failure_trap& trap) noexcept{ };
+    assertion_failure_trap* previous{ };
+    testing::captured_assertion_failure* failure{ };
+    std::size_t context_depth{ };
+  };
+
+  /**
+   * @brief A trap that escapes with `std::longjmp()`.
+   * @details The trap is the first member, so a pointer to it is also a pointer to the jump.
+   */
+  struct assertion_failure_jump final {
+    assertion_failure_trap trap;
+    std::jmp_buf target;
+
+    static void escape(assertion_failure_trap& trap) noexcept {
+      std::longjmp(reinterpret_cast<assertion_failure_jump&>(trap).target, 1);
+    }
+  };
+
+  /**
+   * @brief Push a trap onto the calling thread's stack of traps.
+   * @param trap The trap to push. This **MUST** remain valid until it's popped or triggered.
+   */
+  void push_assertion_failure_trap(assertion_failure_trap& trap) noexcept;
+
+  /**
+   * @brief Pop a trap from the calling thread's stack of traps.
+   * @param trap The innermost trap.
+   */
+  void pop_assertion_failure_trap(assertion_failure_trap& trap) noexcept;
+
+}
+/// @endcond
+
+namespace megatech::testing {
+
+  /**
+   * @brief Call a function and capture the first hard assertion failure that it causes on the calling thread.
+   * @details Soft assertion failures are reported as usual. When a hard assertion fails, the rest of the function is
+   *          skipped with `std::longjmp()`. Destructors of objects in the skipped frames aren't run, so anything they
+   *          own is leaked. Failures on other threads still abort the program. Trapping is only available in hosted
+   *          builds.
+   * @tparam Function The type of the function to call.
+   * @param function The function to call. This **MUST NOT** throw.
+   * @param failure The destination of the captured failure. This is only written if a hard assertion failed.
+   * @return True if a hard assertion failed. Otherwise, false.
+   */
+  template <typename Function>
+  bool capture_assertion_failure(Function&& function, captured_assertion_failure& failure) noexcept {
+    auto jump = internal::base::assertion_failure_jump{ };
+    jump.trap.escape = &internal::base::assertion_failure_jump::escape;
+    jump.trap.failure = &failure;
+    // The trap is removed from the stack before it escapes, so there's nothing to clean up here.
+    if (setjmp(jump.target))
+    {
+      return true;
+    }
+    internal::base::push_assertion_failure_trap(jump.trap);
+    std::invoke(function);
+    internal::base::pop_assertion_failure_trap(jump.trap);
+    return false;
+  }
+
+  /**
+   * @brief Check that a function fails a hard assertion with an expected expression and message.
+   * @details The failure is captured with capture_assertion_failure(). Like the process-based test runner, the actual
+   *          message only needs to contain the expected message.
+   * @tparam Function The type of the function to call.
+   * @param function The function to call. This **MUST NOT** throw.
+   * @param expression The expected expression of the failing assertion.
+   * @param message A string that the failure's message must contain. If this is empty, any message is accepted.
+   * @return True if the function failed an assertion with the expected expression and message. Otherwise, false.
+   */
+  template <typename Function>
+  bool expect_assertion_failure(Function&& function, const std::string_view expression,
+                                const std::string_view message = { }) noexcept {
+    auto failure = captured_assertion_failure{ };
+    if (!capture_assertion_failure(std::forward<Function>(function), failure))
+    {
+      return false;
+    }
+    if (!failure.expression || failure.expression != expression)
+    {
+      return false;
+    }
+    return message.empty() || std::string_view{ failure.message.data() }.find(message) != std::string_view::npos;
+  }
+
+}
+
+#endif
@@ -6,45 +6,282 @@
  * @date 2024
  */
 #include "megatech/assertions.hpp"
+#include "megatech/assertions/journal.hpp"
+#include "megatech/assertions/metrics.hpp"
+#ifndef CONFIG_FREESTANDING
+  #include "megatech/assertions/testing.hpp"
+#endif
 
 #include "config.hpp"
 
 #include <cinttypes>
-#include <cstdio>
 #include <cstdlib>
 #include <cstdarg>
+#include <cstring>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <string_view>
+
+// Freestanding builds never use stdio or the heap. Messages are rendered with a small built-in "printf" instead.
+#ifdef CONFIG_FREESTANDING
+  #ifdef CONFIG_THREAD_SAFE_ASSERTIONS_ENABLED
+    #error "Freestanding builds don't support thread-safe assertions."
+  #endif
+#else
+  #include <cstdio>
+
+  #include <vector>
+#endif
 
 #ifdef CONFIG_THREAD_SAFE_ASSERTIONS_ENABLED
   #define MEGATECH_ASSERTIONS_PT_DECL static thread_local
-
-  #include <mutex>
-  #include <condition_variable>
 #else
   #define MEGATECH_ASSERTIONS_PT_DECL static
 #endif
 
-// This is the prefix format for assertion diagnostics.
-// It needs to contain the file name, line number, and procedure name at the location where an assertion failed.
-#define PREFIX_FORMAT "%s:%" PRIu32 ": %s: "
+// Soft assertion failures can be reported by a background thread instead of the failing thread. This requires
+// thread-safe assertions.
+#if CONFIG_SOFT_ASSERTION_QUEUE_SIZE && defined(CONFIG_THREAD_SAFE_ASSERTIONS_ENABLED)
+  #define MEGATECH_ASSERTIONS_SOFT_QUEUE_ENABLED (1)
+
+  #include <thread>
+#endif
+
+// Reports are written directly to the standard error file descriptor where possible. Unlike stdio, writev(2) and
+// nanosleep(2) are async-signal-safe and never allocate or lock.
+#if !defined(CONFIG_FREESTANDING) && __has_include(<sys/uio.h>) && __has_include(<unistd.h>)
+  #define MEGATECH_ASSERTIONS_POSIX_IO_AVAILABLE (1)
+
+  #include <cerrno>
+  #include <ctime>
+
+  #include <sys/uio.h>
+  #include <unistd.h>
+#elif !defined(CONFIG_FREESTANDING)
+  #include <chrono>
+  #include <thread>
+#endif
+
+// Backtraces are captured by walking the unwind tables into a preallocated buffer. Capture never allocates, and no
+// frame is symbolized until the default handler writes the report.
+#if CONFIG_ASSERTION_BACKTRACE_DEPTH && !defined(CONFIG_FREESTANDING) && __has_include(<unwind.h>)
+  #define MEGATECH_ASSERTIONS_BACKTRACE_AVAILABLE (1)
+
+  #include <unwind.h>
+
+  #if __has_include(<dlfcn.h>)
+    #define MEGATECH_ASSERTIONS_SYMBOLIZATION_AVAILABLE (1)
+
+    #include <dlfcn.h>
+  #endif
+#endif
+
+// The default failure handler can be replaced at build time with a handler provided by the program. This allows builds
+// that never write to standard error.
+#ifdef CONFIG_DEFAULT_ASSERTION_FAILURE_HANDLER
+  #define DEFAULT_FAILURE_HANDLER CONFIG_DEFAULT_ASSERTION_FAILURE_HANDLER
+
+extern "C" void CONFIG_DEFAULT_ASSERTION_FAILURE_HANDLER(const megatech::assertion_failure& failure) noexcept;
+#else
+  #define DEFAULT_FAILURE_HANDLER megatech::default_assertion_failure_handler
+#endif
+
+// Reports can also be written, and the program aborted, by functions provided by the program. Freestanding builds
+// without a write function discard their reports.
+#ifdef CONFIG_ASSERTION_WRITE_FUNCTION
+extern "C" void CONFIG_ASSERTION_WRITE_FUNCTION(const char* data, std::size_t size) noexcept;
+#endif
+
+#ifdef CONFIG_ASSERTION_ABORT_FUNCTION
+extern "C" [[noreturn]] void CONFIG_ASSERTION_ABORT_FUNCTION() noexcept;
+#endif
 
 namespace {
 
+  [[noreturn]] void abort_program() noexcept {
+#ifdef CONFIG_ASSERTION_ABORT_FUNCTION
+    CONFIG_ASSERTION_ABORT_FUNCTION();
+#else
+    std::abort();
+#endif
+  }
+
+#ifndef CONFIG_FREESTANDING
+  // The innermost trap on this thread. Hard failures escape to it instead of being reported.
+  MEGATECH_ASSERTIONS_PT_DECL megatech::internal::base::assertion_failure_trap* pt_assertion_failure_trap{ };
+#endif
+
 #ifdef CONFIG_THREAD_SAFE_ASSERTIONS_ENABLED
-  static std::mutex sg_mtx{ };
-  static std::condition_variable sg_condition{ };
-  static std::size_t sg_unresolved_failures{ 0 };
+  // Failing threads take a ticket from sg_failures. The first CONFIG_ASSERTION_DRAIN_LIMIT + 1 tickets write a report
+  // and then increment sg_resolved. Every failing thread waits until the reports have drained before aborting.
+  // Nothing here ever blocks on a lock, so a thread that fails while another is reporting can't deadlock.
+  static std::atomic<std::size_t> sg_failures{ 0 };
+  static std::atomic<std::size_t> sg_resolved{ 0 };
+
+  // The number of times that a failure has begun on this thread. This is greater than 1 only when an assertion fails
+  // while a previous failure is being processed (e.g., inside of a formatter).
+  MEGATECH_ASSERTIONS_PT_DECL std::size_t pt_failure_depth{ 0 };
+
+  // Failing threads poll the drain state on this interval. Reports are considered drained once they've all resolved
+  // and no new failure has arrived for drain_quiet_polls intervals. After CONFIG_ASSERTION_DRAIN_TIMEOUT milliseconds,
+  // threads give up waiting.
+  constexpr auto drain_poll_interval_ns = long{ 100'000 };
+  constexpr auto drain_quiet_polls = 10;
+  constexpr auto drain_timeout_polls = CONFIG_ASSERTION_DRAIN_TIMEOUT * (1'000'000 / drain_poll_interval_ns);
+
+  // Failures beyond the drain limit aren't reported. Instead, they're counted by site in a small open addressed table
+  // and summarized once by the first thread to finish draining. Sites that don't fit in the table are only counted.
+  struct suppressed_failure final {
+    std::atomic<const megatech::assertion_site*> site{ };
+    std::atomic<std::size_t> count{ };
+  };
+
+  static std::array<suppressed_failure, 16> sg_suppressed_failures{ };
+  static std::atomic<std::size_t> sg_suppressed_elsewhere{ 0 };
+  static std::atomic_flag sg_summary_claimed{ };
+  static std::atomic_flag sg_summary_written{ };
 #endif
 
 #if CONFIG_ASSERTION_BUFFER_CHAR_SIZE
+  using assertion_buffer = std::array<char, CONFIG_ASSERTION_BUFFER_CHAR_SIZE>;
+
+#if CONFIG_ASSERTION_BUFFER_POOL_SIZE
+  // A process-wide pool of buffers for formatted assertion messages. Failing threads claim a buffer atomically, so
+  // threads that never fail don't pay for a buffer at all. If every buffer is claimed, messages are dropped.
+  static std::array<assertion_buffer, CONFIG_ASSERTION_BUFFER_POOL_SIZE> sg_assertion_buffers{ };
+  static std::array<std::atomic_flag, CONFIG_ASSERTION_BUFFER_POOL_SIZE> sg_assertion_buffer_claims{ };
+#else
   // A per-thread buffer for formatted assertion messages.
   // Creating lots of threads, therefore, will consume a considerable amount of memory if this is very large.
   // The default size is 4001 characters (i.e., enough for 1000 4-byte UTF-8 code points and a NUL terminator) or
   // roughly 4KiB. If this memory cost is an issue you should tune the library configuration to meet your needs.
   // If either CONFIG_ASSERTION_BUFFER_SIZE or CONFIG_MAX_CODE_POINT_SIZE are 0, then this is disabled.
-  MEGATECH_ASSERTIONS_PT_DECL std::array<char, CONFIG_ASSERTION_BUFFER_CHAR_SIZE> pt_assertion_buffer{ };
+  // Setting CONFIG_ASSERTION_BUFFER_POOL_SIZE replaces this with a shared pool.
+  MEGATECH_ASSERTIONS_PT_DECL assertion_buffer pt_assertion_buffer{ };
+#endif
+
+  class assertion_buffer_claim;
+
+#if CONFIG_ASSERTION_BUFFER_POOL_SIZE
+  // The innermost pooled buffer claim on this thread. Trapped failures never destroy their claims, so they're released
+  // through this list instead.
+  MEGATECH_ASSERTIONS_PT_DECL assertion_buffer_claim* pt_assertion_buffer_claims{ };
+#endif
+
+  // A claim on an assertion buffer. Claims on pooled buffers are released when the claim is destroyed. If no buffer is
+  // available, the claim is empty.
+  class assertion_buffer_claim final {
+  private:
+    assertion_buffer* m_buffer{ };
+#if CONFIG_ASSERTION_BUFFER_POOL_SIZE
+    std::size_t m_index{ };
+    assertion_buffer_claim* m_previous{ pt_assertion_buffer_claims };
+#endif
+  public:
+    assertion_buffer_claim() noexcept {
+#if CONFIG_ASSERTION_BUFFER_POOL_SIZE
+      pt_assertion_buffer_claims = this;
+      for (auto i = std::size_t{ 0 }; i < sg_assertion_buffers.size(); ++i)
+      {
+        if (!sg_assertion_buffer_claims[i].test_and_set(std::memory_order_acquire))
+        {
+          m_buffer = &sg_assertion_buffers[i];
+          m_index = i;
+          return;
+        }
+      }
+#else
+      m_buffer = &pt_assertion_buffer;
+#endif
+    }
+    assertion_buffer_claim(const assertion_buffer_claim& other) = delete;
+    assertion_buffer_claim(assertion_buffer_claim&& other) = delete;
+
+    ~assertion_buffer_claim() noexcept {
+#if CONFIG_ASSERTION_BUFFER_POOL_SIZE
+      release();
+      pt_assertion_buffer_claims = m_previous;
+#endif
+    }
+
+    assertion_buffer_claim& operator=(const assertion_buffer_claim& rhs) = delete;
+    assertion_buffer_claim& operator=(assertion_buffer_claim&& rhs) = delete;
+
+    explicit operator bool() const noexcept {
+      return m_buffer;
+    }
+
+    char* data() noexcept {
+      return m_buffer->data();
+    }
+
+    std::size_t size() const noexcept {
+      return m_buffer->size();
+    }
+
+#if CONFIG_ASSERTION_BUFFER_POOL_SIZE
+    void release() noexcept {
+      if (m_buffer)
+      {
+        sg_assertion_buffer_claims[m_index].clear(std::memory_order_release);
+        m_buffer = nullptr;
+      }
+    }
+
+    // Release every claim on this thread without destroying them.
+    static void release_all() noexcept {
+      for (auto claim = pt_assertion_buffer_claims; claim; claim = claim->m_previous)
+      {
+        claim->release();
+      }
+      pt_assertion_buffer_claims = nullptr;
+    }
+#endif
+  };
+
+  constexpr auto no_buffer_error = "No assertion message buffer was available.";
+
+#ifdef MEGATECH_ASSERTIONS_BACKTRACE_AVAILABLE
+  // The return addresses of the current failure on this thread.
+  MEGATECH_ASSERTIONS_PT_DECL std::array<const void*, CONFIG_ASSERTION_BACKTRACE_DEPTH> pt_backtrace{ };
+
+  struct backtrace_capture final {
+    const void** frames{ };
+    std::size_t size{ };
+    std::size_t capacity{ };
+    std::size_t skipped{ };
+  };
+
+  _Unwind_Reason_Code capture_frame(_Unwind_Context* context, void* argument) noexcept {
+    auto& capture = *static_cast<backtrace_capture*>(argument);
+    const auto address = _Unwind_GetIP(context);
+    if (!address)
+    {
+      return _URC_END_OF_STACK;
+    }
+    if (capture.skipped)
+    {
+      --capture.skipped;
+      return _URC_NO_REASON;
+    }
+    capture.frames[capture.size++] = reinterpret_cast<const void*>(address);
+    return capture.size < capture.capacity ? _URC_NO_REASON : _URC_END_OF_STACK;
+  }
+
+  // Capture the current call stack, excluding this function. This is never inlined, so exactly one frame is skipped.
+  [[gnu::noinline]] std::size_t capture_backtrace(std::array<const void*, CONFIG_ASSERTION_BACKTRACE_DEPTH>& frames)
+  noexcept {
+    auto capture = backtrace_capture{ frames.data(), 0, frames.size(), 1 };
+    _Unwind_Backtrace(capture_frame, &capture);
+    return capture.size;
+  }
+#endif
 
   // This is a truncating output iterator type. Basically, it writes into a buffer until some size has been exceeded.
   // After that, the incoming output is simply discarded. This behaves similiarly to types like
@@ -89,202 +326,1730 @@ namespace {
     constexpr truncating_iterator& operator*() {
       return *this;
     }
-  };
-#endif
-
-}
 
-namespace megatech::internal::base {
+    constexpr std::size_t position() const {
+      return m_current;
+    }
+  };
 
-#if CONFIG_ASSERTION_BUFFER_CHAR_SIZE
-  void dispatch_assertion_failure_with_message(const std::source_location& location, const char* expression,
-                                               const char* message) noexcept {
-#ifdef CONFIG_THREAD_SAFE_ASSERTIONS_ENABLED
-      try
-#endif
+#ifdef CONFIG_FREESTANDING
+  // A small "printf" for freestanding builds. This supports the flags "-", "+", " ", "#", and "0", field widths,
+  // precisions, the length modifiers "hh", "h", "l", "ll", "j", "z", "t", and "L", and every standard conversion except
+  // "n". Floating-point values are approximated in fixed notation with at most 9 fractional digits, and values too
+  // large for an integer are written as "?". Like vsnprintf(), the output is truncated and NUL-terminated, and this
+  // returns the untruncated length.
+  int format_printf(char *const data, const std::size_t size, const char* format, std::va_list args) noexcept {
+    auto position = std::size_t{ 0 };
+    const auto put = [&](const char c, std::size_t count = 1) {
+      for (; count; --count, ++position)
       {
-#ifdef CONFIG_THREAD_SAFE_ASSERTIONS_ENABLED
+        if (position + 1 < size)
         {
-          auto lock = std::lock_guard<std::mutex>{ sg_mtx };
-          // We're in the middle of resolving the assertion.
-          ++sg_unresolved_failures;
+          data[position] = c;
         }
-#endif
-        // If the caller didn't provide an expression, it should be an empty string.
-        if (!expression)
+      }
+    };
+    while (*format)
+    {
+      if (*format != '%')
+      {
+        put(*format++);
+        continue;
+      }
+      ++format;
+      auto left = false;
+      auto zero = false;
+      auto sign = '\0';
+      auto alternate = false;
+      for (;; ++format)
+      {
+        if (*format == '-')
         {
-          expression = "";
+          left = true;
         }
-        if (!message)
+        else if (*format == '0')
         {
-          message = "";
+          zero = true;
         }
+        else if (*format == '+' || (*format == ' ' && sign != '+'))
         {
-#ifdef CONFIG_THREAD_SAFE_ASSERTIONS_ENABLED
-          auto lock = std::lock_guard<std::mutex>{ sg_mtx };
-#endif
-          std::fprintf(stderr, PREFIX_FORMAT "The assertion \"%s\" failed with the message \"%s\".\n",
-                       location.file_name(), location.line(), location.function_name(), expression, message);
+          sign = *format;
+        }
+        else if (*format == '#')
+        {
+          alternate = true;
+        }
+        else
+        {
+          break;
         }
       }
-#ifdef CONFIG_THREAD_SAFE_ASSERTIONS_ENABLED
-      catch (...)
+      const auto read_number = [&]() {
+        if (*format == '*')
+        {
+          ++format;
+          return va_arg(args, int);
+        }
+        auto result = 0;
+        for (; *format >= '0' && *format <= '9'; ++format)
+        {
+          result = result * 10 + (*format - '0');
+        }
+        return result;
+      };
+      auto width = read_number();
+      if (width < 0)
       {
-        dispatch_assertion_failure_with_error(location, expression, "A concurrency error occurred while processing an "
-                                                                    "assertion failure. Locking the assertion mutex "
-                                                                    "may have failed.");
+        left = true;
+        width = -width;
       }
-      try
+      auto precision = -1;
+      if (*format == '.')
       {
-        {
-          // Although the lock could be released before notifying, it isn't maximally safe. Assertions aren't a
-          // performance feature. The program is about to fail hard, so this is fine.
-          auto lock = std::lock_guard<std::mutex>{ sg_mtx };
-          if (sg_unresolved_failures == 1)
-          {
-            // Notifying will wake up all waiting threads. Then they will immediately block on the lock that they can't
-            // acquire.
-            sg_condition.notify_all();
-          }
-          // The assertion is resolved.
-          --sg_unresolved_failures;
-        }
-        // Wait for any pending assertions to resolve.
-        auto lock = std::unique_lock<std::mutex>{ sg_mtx };
-        sg_condition.wait(lock, [](){ return !sg_unresolved_failures; });
+        ++format;
+        precision = read_number();
       }
-      // Ignore post-processing errors, just abort.
-      catch (...) { }
-#endif
-      std::abort();
-  }
-#endif
-
-  void dispatch_assertion_failure(const std::source_location& location, const char* expression) noexcept {
-#ifdef CONFIG_THREAD_SAFE_ASSERTIONS_ENABLED
-      try
-#endif
+      auto length = 0;
+      for (; *format == 'h'; ++format)
       {
-#ifdef CONFIG_THREAD_SAFE_ASSERTIONS_ENABLED
+        --length;
+      }
+      for (; *format == 'l'; ++format)
+      {
+        ++length;
+      }
+      const auto modifier = *format == 'j' || *format == 'z' || *format == 't' || *format == 'L' ? *format++ : '\0';
+      const auto pad = [&](const std::size_t used) {
+        return static_cast<std::size_t>(width) > used ? static_cast<std::size_t>(width) - used : 0;
+      };
+      const auto put_text = [&](const char* text, std::size_t count) {
+        if (!left)
         {
-          auto lock = std::lock_guard<std::mutex>{ sg_mtx };
-          ++sg_unresolved_failures;
+          put(' ', pad(count));
         }
-#endif
-        if (!expression)
+        for (auto i = std::size_t{ 0 }; i < count; ++i)
         {
-          expression = "";
+          put(text[i]);
         }
+        if (left)
         {
-#ifdef CONFIG_THREAD_SAFE_ASSERTIONS_ENABLED
-          auto lock = std::lock_guard<std::mutex>{ sg_mtx };
-#endif
-          std::fprintf(stderr, PREFIX_FORMAT "The assertion \"%s\" failed.\n", location.file_name(), location.line(),
-                       location.function_name(), expression);
+          put(' ', pad(count));
+        }
+      };
+      const auto put_integer = [&](unsigned long long value, const bool negative, const unsigned base,
+                                   const bool upper, const char* prefix) {
+        constexpr auto lower_digits = "0123456789abcdef";
+        constexpr auto upper_digits = "0123456789ABCDEF";
+        auto digits = std::array<char, 24>{ };
+        auto count = std::size_t{ 0 };
+        for (; value && count < digits.size(); value /= base)
+        {
+          digits[count++] = (upper ? upper_digits : lower_digits)[value % base];
+        }
+        // A precision of 0 writes nothing for a value of 0.
+        if (!count && precision)
+        {
+          digits[count++] = '0';
+        }
+        const auto minimum = precision < 0 ? std::size_t{ 1 } : static_cast<std::size_t>(precision);
+        const auto zeros = minimum > count ? minimum - count : 0;
+        const auto prefix_size = std::strlen(prefix) + (negative || sign);
+        const auto padding = pad(prefix_size + zeros + count);
+        const auto zero_padded = zero && !left && precision < 0;
+        if (!left && !zero_padded)
+        {
+          put(' ', padding);
+        }
+        if (negative || sign)
+        {
+          put(negative ? '-' : sign);
+        }
+        for (; *prefix; ++prefix)
+        {
+          put(*prefix);
+        }
+        put('0', zeros + (zero_padded ? padding : 0));
+        while (count)
+        {
+          put(digits[--count]);
+        }
+        if (left)
+        {
+          put(' ', padding);
+        }
+      };
+      const auto read_signed = [&]() -> long long {
+        switch (modifier)
+        {
+        case 'j':
+          return va_arg(args, std::intmax_t);
+        case 'z':
+          return va_arg(args, std::make_signed_t<std::size_t>);
+        case 't':
+          return va_arg(args, std::ptrdiff_t);
+        default:
+          break;
+        }
+        switch (length)
+        {
+        case -2:
+          return static_cast<signed char>(va_arg(args, int));
+        case -1:
+          return static_cast<short>(va_arg(args, int));
+        case 1:
+          return va_arg(args, long);
+        case 2:
+          return va_arg(args, long long);
+        default:
+          return va_arg(args, int);
+        }
+      };
+      const auto read_unsigned = [&]() -> unsigned long long {
+        switch (modifier)
+        {
+        case 'j':
+          return va_arg(args, std::uintmax_t);
+        case 'z':
+          return va_arg(args, std::size_t);
+        case 't':
+          return static_cast<std::make_unsigned_t<std::ptrdiff_t>>(va_arg(args, std::ptrdiff_t));
+        default:
+          break;
+        }
+        switch (length)
+        {
+        case -2:
+          return static_cast<unsigned char>(va_arg(args, unsigned));
+        case -1:
+          return static_cast<unsigned short>(va_arg(args, unsigned));
+        case 1:
+          return va_arg(args, unsigned long);
+        case 2:
+          return va_arg(args, unsigned long long);
+        default:
+          return va_arg(args, unsigned);
+        }
+      };
+      switch (const auto conversion = *format ? *format++ : '\0')
+      {
+      case 'd':
+      case 'i':
+      {
+        const auto value = read_signed();
+        // The magnitude is computed in unsigned arithmetic, so the most negative value doesn't overflow.
+        const auto magnitude = value < 0 ? 0ull - static_cast<unsigned long long>(value) :
+                                           static_cast<unsigned long long>(value);
+        put_integer(magnitude, value < 0, 10, false, "");
+        break;
+      }
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+      {
+        sign = '\0';
+        const auto value = read_unsigned();
+        const auto base = conversion == 'u' ? 10u : conversion == 'o' ? 8u : 16u;
+        auto prefix = "";
+        if (alternate && value && base == 16)
+        {
+          prefix = conversion == 'x' ? "0x" : "0X";
         }
+        else if (alternate && value && base == 8)
+        {
+          prefix = "0";
+        }
+        put_integer(value, false, base, conversion == 'X', prefix);
+        break;
       }
-#ifdef CONFIG_THREAD_SAFE_ASSERTIONS_ENABLED
-      catch (...)
+      case 'p':
+        sign = '\0';
+        put_integer(reinterpret_cast<std::uintptr_t>(va_arg(args, void*)), false, 16, false, "0x");
+        break;
+      case 'c':
       {
-        dispatch_assertion_failure_with_error(location, expression, "A concurrency error occurred while processing an "
-                                                                    "assertion failure. Llocking the assertion mutex "
-                                                                    "may have failed.");
+        const auto c = static_cast<char>(va_arg(args, int));
+        put_text(&c, 1);
+        break;
       }
-      try
+      case 's':
+      {
+        auto text = va_arg(args, const char*);
+        text = text ? text : "(null)";
+        auto count = std::size_t{ 0 };
+        for (; text[count] && (precision < 0 || count < static_cast<std::size_t>(precision)); ++count) { }
+        put_text(text, count);
+        break;
+      }
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
       {
+        const auto value = modifier == 'L' ? va_arg(args, long double) : va_arg(args, double);
+        const auto negative = value < 0;
+        const auto magnitude = negative ? -value : value;
+        auto text = std::array<char, 48>{ };
+        auto count = std::size_t{ 0 };
+        if (negative || sign)
+        {
+          text[count++] = negative ? '-' : sign;
+        }
+        const auto numbers = count;
+        const auto append = [&](const std::string_view part) {
+          for (const auto c : part)
+          {
+            text[count++] = c;
+          }
+        };
+        const auto upper = conversion >= 'A' && conversion <= 'Z';
+        if (magnitude != magnitude)
+        {
+          append(upper ? "NAN" : "nan");
+        }
+        else if (magnitude > 1e19L)
+        {
+          // Infinities and values that don't fit in an integer are only approximated.
+          append(magnitude == magnitude * 2 ? (upper ? "INF" : "inf") : "?");
+        }
+        else
+        {
+          const auto digits = precision < 0 ? 6 : precision > 9 ? 9 : precision;
+          auto scale = 1ull;
+          for (auto i = 0; i < digits; ++i)
+          {
+            scale *= 10;
+          }
+          auto whole = static_cast<unsigned long long>(magnitude);
+          auto fraction = static_cast<unsigned long long>((magnitude - whole) * scale + 0.5L);
+          if (fraction >= scale)
+          {
+            ++whole;
+            fraction -= scale;
+          }
+          auto reversed = std::array<char, 20>{ };
+          auto reversed_size = std::size_t{ 0 };
+          do
+          {
+            reversed[reversed_size++] = static_cast<char>('0' + whole % 10);
+            whole /= 10;
+          }
+          while (whole);
+          while (reversed_size)
+          {
+            text[count++] = reversed[--reversed_size];
+          }
+          if (digits || alternate)
+          {
+            text[count++] = '.';
+          }
+          for (auto i = digits; i > 0; --i)
+          {
+            text[count + i - 1] = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+          }
+          count += static_cast<std::size_t>(digits);
+        }
+        if (zero && !left && magnitude == magnitude && magnitude <= 1e19L)
         {
-          auto lock = std::lock_guard<std::mutex>{ sg_mtx };
-          if (sg_unresolved_failures == 1)
+          // Zeros are inserted between the sign and the digits.
+          for (auto i = std::size_t{ 0 }; i < numbers; ++i)
+          {
+            put(text[i]);
+          }
+          put('0', pad(count));
+          for (auto i = numbers; i < count; ++i)
           {
-            sg_condition.notify_all();
+            put(text[i]);
           }
-          --sg_unresolved_failures;
         }
-        auto lock = std::unique_lock<std::mutex>{ sg_mtx };
-        sg_condition.wait(lock, [](){ return !sg_unresolved_failures; });
+        else
+        {
+          put_text(text.data(), count);
+        }
+        break;
       }
-      catch (...) { }
-#endif
-      std::abort();
+      case 'n':
+        // Nothing is ever written through the argument.
+        (void) va_arg(args, void*);
+        break;
+      case '%':
+        put('%');
+        break;
+      case '\0':
+        break;
+      default:
+        put('%');
+        put(conversion);
+        break;
+      }
+    }
+    if (size)
+    {
+      data[position < size ? position : size - 1] = '\0';
+    }
+    return static_cast<int>(position);
   }
+#endif
 
-  void dispatch_assertion_failure_with_error(const std::source_location& location, const char* expression,
-                                             const char* error) noexcept {
-    if (!expression)
+  // Render a "printf"-style message into a buffer. On success, this returns nullptr. Otherwise, it returns an error.
+  const char* render_message(assertion_buffer_claim& buffer, const char* format, std::va_list args) noexcept {
+    if (!buffer)
     {
-      expression = "";
+      return no_buffer_error;
     }
-    if (!error)
+#ifdef CONFIG_FREESTANDING
+    if (format_printf(buffer.data(), buffer.size(), format, args) <= 0)
+#else
+    if (std::vsnprintf(buffer.data(), buffer.size(), format, args) <= 0)
+#endif
     {
-      error = "";
+      return "A formatting error occurred.";
     }
-    std::fprintf(stderr, PREFIX_FORMAT "The assertion \"%s\" failed.\nThe following error occurred during assertion "
-                         "failure processing: \"%s\"\n", location.file_name(), location.line(),
-                 location.function_name(), expression, error);
-    std::abort();
+    return nullptr;
   }
 
 #ifdef MEGATECH_ASSERTIONS_FORMAT_AVAILABLE
-  void debug_assertion_format(const std::source_location& location, const bool condition, const char *const expression,
-                              const std::string_view& format, std::format_args&& args) noexcept {
-// If the assertion buffer is disabled, immediately defer to a bufferless assertion.
-#if CONFIG_ASSERTION_BUFFER_CHAR_SIZE
-    if (!condition)
+  // Render a "format"-style message into a buffer. On success, this returns nullptr. Otherwise, it returns an error.
+  const char* render_message(assertion_buffer_claim& buffer, const char* format, std::format_args& args) noexcept {
+    if (!buffer)
     {
-      try
-      {
-        std::vformat_to(truncating_iterator<char>{ pt_assertion_buffer.data(), pt_assertion_buffer.size() - 1 },
-                        format, args);
-      }
-      catch (const std::format_error& err)
-      {
-        dispatch_assertion_failure_with_error(location, expression, "A formatting error occurred.");
-      }
-      catch (...)
-      {
-        dispatch_assertion_failure_with_error(location, expression, "An unknown error occurred while formatting.");
-      }
-      dispatch_assertion_failure_with_message(location, expression, pt_assertion_buffer.data());
+      return no_buffer_error;
+    }
+    const auto render = [&]() {
+      // Buffers are reused, so the message must be terminated here.
+      const auto end = std::vformat_to(truncating_iterator<char>{ buffer.data(), buffer.size() - 1 },
+                                       std::string_view{ format }, args);
+      buffer.data()[end.position()] = '\0';
+    };
+#ifdef __cpp_exceptions
+    try
+    {
+      render();
+    }
+    catch (const std::format_error& err)
+    {
+      return "A formatting error occurred.";
+    }
+    catch (...)
+    {
+      return "An unknown error occurred while formatting.";
     }
 #else
-    (void) format;
-    (void) args;
-    debug_assertion(location, condition, expression);
+    // Without exceptions, the standard library terminates the program on a formatting error.
+    render();
 #endif
+    return nullptr;
   }
+#endif
 #endif
 
-}
+  // A diagnostic report assembled from pieces. Reports are written with a single call so that concurrent reports
+  // don't interleave. Assembling the report never allocates.
+  class assertion_report final {
+  private:
+#ifdef MEGATECH_ASSERTIONS_POSIX_IO_AVAILABLE
+    using part = iovec;
+#else
+    struct part final {
+      void* iov_base{ };
+      std::size_t iov_len{ };
+    };
+#endif
+    std::array<part, 16> m_parts{ };
+    std::size_t m_size{ };
+    // Enough space for any 32-bit line number.
+    std::array<char, 10> m_line{ };
+    // Enough space for any 64-bit count.
+    std::array<char, 20> m_count{ };
+    // Enough space for a 32-bit site ID in hexadecimal, including the "0x" prefix.
+    std::array<char, 10> m_id{ };
+    // Enough space for three addresses in hexadecimal, including their "0x" prefixes.
+    std::array<char, 3 * (2 + 2 * sizeof(std::uintptr_t))> m_addresses{ };
+    std::size_t m_addresses_size{ };
+  public:
+    void append(const char* text) noexcept {
+      if (text && *text && m_size < m_parts.size())
+      {
+        m_parts[m_size++] = part{ const_cast<char*>(text), std::strlen(text) };
+      }
+    }
 
-namespace megatech {
+    void append(std::uint_least32_t line) noexcept {
+      auto current = m_line.size();
+      do
+      {
+        m_line[--current] = static_cast<char>('0' + line % 10);
+        line /= 10;
+      }
+      while (line && current);
+      if (m_size < m_parts.size())
+      {
+        m_parts[m_size++] = part{ m_line.data() + current, m_line.size() - current };
+      }
+    }
 
-  void debug_assertion(const std::source_location& location, const bool condition,
-                       const char *const expression) noexcept {
-    if (!condition)
-    {
-      internal::base::dispatch_assertion_failure(location, expression);
+    // Counts are right-aligned in a field of at least the given width. This is used instead of snprintf(), which isn't
+    // async-signal-safe.
+    void append_count(std::uint_least64_t count, const std::size_t width) noexcept {
+      auto current = m_count.size();
+      do
+      {
+        m_count[--current] = static_cast<char>('0' + count % 10);
+        count /= 10;
+      }
+      while (count && current);
+      while (m_count.size() - current < width && current)
+      {
+        m_count[--current] = ' ';
+      }
+      if (m_size < m_parts.size())
+      {
+        m_parts[m_size++] = part{ m_count.data() + current, m_count.size() - current };
+      }
     }
-  }
 
-  void debug_assertion_printf(const std::source_location& location, const bool condition, const char *const expression,
-                              const char *const format, ...) noexcept {
-#if CONFIG_ASSERTION_BUFFER_CHAR_SIZE
-    if (!condition)
-    {
-      std::va_list args;
-      va_start(args, format);
-      const auto res = std::vsnprintf(pt_assertion_buffer.data(), pt_assertion_buffer.size(), format, args);
-      va_end(args);
-      if (res <= 0)
+    void append_id(std::uint_least32_t id) noexcept {
+      constexpr auto digits = "0123456789abcdef";
+      m_id[0] = '0';
+      m_id[1] = 'x';
+      for (auto current = m_id.size(); current > 2; id >>= 4)
+      {
+        m_id[--current] = digits[id & 0xf];
+      }
+      if (m_size < m_parts.size())
       {
-        internal::base::dispatch_assertion_failure_with_error(location, expression, "A formatting error occurred.");
+        m_parts[m_size++] = part{ m_id.data(), m_id.size() };
       }
-      internal::base::dispatch_assertion_failure_with_message(location, expression, pt_assertion_buffer.data());
     }
-#else
-    (void) format;
-    debug_assertion(location, condition, expression);
-#endif
-  }
+
+    void append_address(std::uintptr_t address) noexcept {
+      constexpr auto digits = "0123456789abcdef";
+      constexpr auto size = 2 + 2 * sizeof(std::uintptr_t);
+      if (m_addresses_size + size > m_addresses.size() || m_size >= m_parts.size())
+      {
+        return;
+      }
+      const auto begin = m_addresses.data() + m_addresses_size;
+      auto current = size;
+      do
+      {
+        begin[--current] = digits[address & 0xf];
+        address >>= 4;
+      }
+      while (address);
+      begin[--current] = 'x';
+      begin[--current] = '0';
+      m_addresses_size += size;
+      m_parts[m_size++] = part{ begin + current, size - current };
+    }
+
+    void write() noexcept {
+#if defined(CONFIG_ASSERTION_WRITE_FUNCTION)
+      for (auto i = std::size_t{ 0 }; i < m_size; ++i)
+      {
+        CONFIG_ASSERTION_WRITE_FUNCTION(static_cast<const char*>(m_parts[i].iov_base), m_parts[i].iov_len);
+      }
+#elif defined(MEGATECH_ASSERTIONS_POSIX_IO_AVAILABLE)
+      auto parts = m_parts.data();
+      auto count = m_size;
+      while (count)
+      {
+        const auto written = writev(STDERR_FILENO, parts, static_cast<int>(count));
+        if (written < 0)
+        {
+          if (errno == EINTR)
+          {
+            continue;
+          }
+          return;
+        }
+        // Resume after a partial write.
+        auto remaining = static_cast<std::size_t>(written);
+        while (count && remaining >= parts->iov_len)
+        {
+          remaining -= parts->iov_len;
+          ++parts;
+          --count;
+        }
+        if (count)
+        {
+          parts->iov_base = static_cast<char*>(parts->iov_base) + remaining;
+          parts->iov_len -= remaining;
+        }
+      }
+#elif !defined(CONFIG_FREESTANDING)
+      for (auto i = std::size_t{ 0 }; i < m_size; ++i)
+      {
+        std::fwrite(m_parts[i].iov_base, 1, m_parts[i].iov_len, stderr);
+      }
+      std::fflush(stderr);
+#endif
+    }
+  };
+
+  // Append the location of a site to a report. Compact sites only have an ID. Their location and expression are
+  // recovered offline from the side table.
+  void append_site_location(assertion_report& report, const megatech::assertion_site& site) noexcept {
+    if (site.file_name)
+    {
+      report.append(site.file_name);
+      report.append(":");
+      report.append(site.line);
+      report.append(": ");
+      report.append(site.function_name);
+    }
+    else
+    {
+      report.append("[");
+      report.append_id(site.id);
+      report.append("]");
+    }
+  }
+
+  // Write a diagnostic for a failing assertion. If error is non-null, the message is ignored.
+  void write_assertion_report(const megatech::assertion_failure& failure) noexcept {
+    const auto& site = *failure.site;
+    const auto kind = failure.soft ? "soft assertion" : "assertion";
+    auto report = assertion_report{ };
+    append_site_location(report, site);
+    report.append(": The ");
+    report.append(kind);
+    if (site.expression)
+    {
+      report.append(" \"");
+      report.append(site.expression);
+      report.append("\"");
+    }
+    if (failure.error)
+    {
+      report.append(" failed.\nThe following error occurred during ");
+      report.append(kind);
+      report.append(" failure processing: \"");
+      report.append(failure.error);
+      report.append("\"\n");
+    }
+    else if (failure.message)
+    {
+      report.append(" failed with the message \"");
+      report.append(failure.message);
+      report.append("\".\n");
+    }
+    else
+    {
+      report.append(" failed.\n");
+    }
+    report.write();
+  }
+
+  // Write a failure's backtrace, one frame per line. Frames are only symbolized here. Each frame includes its module
+  // and its offset into that module, so that frames in modules without exported symbols can be symbolized offline
+  // (e.g., with addr2line).
+  void write_backtrace(const megatech::assertion_failure& failure) noexcept {
+    if (!failure.backtrace_size)
+    {
+      return;
+    }
+    auto header = assertion_report{ };
+    header.append("Backtrace:\n");
+    header.write();
+    for (auto i = std::size_t{ 0 }; i < failure.backtrace_size; ++i)
+    {
+      const auto address = failure.backtrace[i];
+      auto report = assertion_report{ };
+      report.append("  #");
+      report.append(static_cast<std::uint_least32_t>(i));
+      report.append(" ");
+      report.append_address(reinterpret_cast<std::uintptr_t>(address));
+#ifdef MEGATECH_ASSERTIONS_SYMBOLIZATION_AVAILABLE
+      auto info = Dl_info{ };
+      if (dladdr(address, &info) && info.dli_fname && *info.dli_fname)
+      {
+        const auto offset = [address](const void* base) {
+          return reinterpret_cast<std::uintptr_t>(address) - reinterpret_cast<std::uintptr_t>(base);
+        };
+        report.append(" in ");
+        report.append(info.dli_fname);
+        report.append("+");
+        report.append_address(offset(info.dli_fbase));
+        if (info.dli_sname)
+        {
+          report.append(" (");
+          report.append(info.dli_sname);
+          report.append("+");
+          report.append_address(offset(info.dli_saddr));
+          report.append(")");
+        }
+      }
+#endif
+      report.append("\n");
+      report.write();
+    }
+  }
+
+  // The current failure handler. This is only loaded on the failure path.
+  static std::atomic<megatech::assertion_failure_handler> sg_failure_handler{ DEFAULT_FAILURE_HANDLER };
+
+  // Pass a failure to the current handler. The handler is only loaded here, so passing assertions never touch it.
+  void deliver_assertion_failure(const megatech::assertion_failure& failure) noexcept {
+#ifndef CONFIG_FREESTANDING
+    // The journal is written first, so the failure is recorded even if the handler never returns.
+    megatech::internal::base::journal_assertion_failure(failure);
+#endif
+    const auto handler = sg_failure_handler.load(std::memory_order_acquire);
+    handler(failure);
+  }
+
+#ifndef CONFIG_FREESTANDING
+  // Copy a hard failure into the innermost trap and escape to it. Nothing is reported, and the escape never returns.
+  [[noreturn]] void trap_assertion_failure(const megatech::assertion_site& site, const char* message,
+                                           const char* error) noexcept {
+    const auto trap = pt_assertion_failure_trap;
+    pt_assertion_failure_trap = trap->previous;
+    auto& failure = *trap->failure;
+    failure.file_name = site.file_name;
+    failure.line = site.line;
+    failure.function_name = site.function_name;
+    failure.expression = site.expression;
+    failure.id = site.id;
+    failure.error = error;
+    failure.has_message = !error && message;
+    auto i = std::size_t{ 0 };
+    for (; failure.has_message && message[i] && i < failure.message.size() - 1; ++i)
+    {
+      failure.message[i] = message[i];
+    }
+    failure.message[i] = '\0';
+#if CONFIG_ASSERTION_BUFFER_CHAR_SIZE && CONFIG_ASSERTION_BUFFER_POOL_SIZE
+    // The message has been copied, so the buffers can be reused.
+    assertion_buffer_claim::release_all();
+#endif
+    // The escape skips the destructors of every context scope created inside of the trap.
+    megatech::internal::base::pt_assertion_contexts.depth = trap->context_depth;
+    trap->escape(*trap);
+    abort_program();
+  }
+#endif
+
+  // Describe a failure on the failing thread and pass it to the current handler.
+  void handle_assertion_failure(const megatech::assertion_site& site, const bool soft, const char* message,
+                                const char* error) noexcept {
+#ifndef CONFIG_FREESTANDING
+    if (!soft && pt_assertion_failure_trap)
+    {
+      trap_assertion_failure(site, message, error);
+    }
+#endif
+    auto failure = megatech::assertion_failure{ &site, error ? nullptr : message, error, soft };
+#ifdef MEGATECH_ASSERTIONS_BACKTRACE_AVAILABLE
+    failure.backtrace = pt_backtrace.data();
+    failure.backtrace_size = capture_backtrace(pt_backtrace);
+#endif
+    const auto& contexts = megatech::internal::base::pt_assertion_contexts;
+    failure.contexts = contexts.entries.data();
+    failure.context_depth = contexts.depth;
+    deliver_assertion_failure(failure);
+  }
+
+#ifdef CONFIG_THREAD_SAFE_ASSERTIONS_ENABLED
+  // Temporary sites are distinct objects on each thread, so sites are also equal when they describe the same location.
+  bool same_site(const megatech::assertion_site& a, const megatech::assertion_site& b) noexcept {
+    return &a == &b || (a.line == b.line && a.id == b.id && a.file_name == b.file_name && a.expression == b.expression);
+  }
+
+  void count_suppressed_failure(const megatech::assertion_site& site) noexcept {
+    const auto start = static_cast<std::size_t>(site.line ^ site.id);
+    for (auto i = std::size_t{ 0 }; i < sg_suppressed_failures.size(); ++i)
+    {
+      auto& slot = sg_suppressed_failures[(start + i) % sg_suppressed_failures.size()];
+      auto current = slot.site.load(std::memory_order_acquire);
+      if (!current && slot.site.compare_exchange_strong(current, &site, std::memory_order_acq_rel))
+      {
+        current = &site;
+      }
+      if (same_site(*current, site))
+      {
+        slot.count.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+    }
+    sg_suppressed_elsewhere.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Write a summary of every suppressed failure. Custom handlers never see suppressed failures, so the summary is only
+  // written when failures are going to standard error.
+  void write_suppressed_failure_summary() noexcept {
+    constexpr auto limit = std::size_t{ CONFIG_ASSERTION_DRAIN_LIMIT } + 1;
+    const auto failures = sg_failures.load(std::memory_order_acquire);
+    if (failures <= limit ||
+        sg_failure_handler.load(std::memory_order_acquire) != megatech::default_assertion_failure_handler)
+    {
+      return;
+    }
+    auto header = assertion_report{ };
+    header.append("Unreported assertion failures: ");
+    header.append_count(failures - limit, 0);
+    header.append("\n");
+    header.write();
+    for (const auto& slot : sg_suppressed_failures)
+    {
+      const auto site = slot.site.load(std::memory_order_acquire);
+      if (!site)
+      {
+        continue;
+      }
+      auto report = assertion_report{ };
+      report.append_count(slot.count.load(std::memory_order_relaxed), 8);
+      report.append(" at ");
+      append_site_location(report, *site);
+      if (site->expression)
+      {
+        report.append(": \"");
+        report.append(site->expression);
+        report.append("\"");
+      }
+      report.append("\n");
+      report.write();
+    }
+    const auto elsewhere = sg_suppressed_elsewhere.load(std::memory_order_relaxed);
+    if (elsewhere)
+    {
+      auto report = assertion_report{ };
+      report.append_count(elsewhere, 8);
+      report.append(" at other sites\n");
+      report.write();
+    }
+  }
+
+  void pause_briefly() noexcept {
+#ifdef MEGATECH_ASSERTIONS_POSIX_IO_AVAILABLE
+    const auto duration = timespec{ 0, drain_poll_interval_ns };
+    nanosleep(&duration, nullptr);
+#else
+    std::this_thread::sleep_for(std::chrono::nanoseconds{ drain_poll_interval_ns });
+#endif
+  }
+#endif
+
+#ifdef MEGATECH_ASSERTIONS_SOFT_QUEUE_ENABLED
+  // Soft failures are pushed into a bounded queue and reported in batches by a background thread. Producers claim a
+  // slot with a single compare-and-swap and never wait. If the queue is full, the failure is dropped and counted
+  // instead. Each slot's sequence number is stored relative to the slot's index, so a zero-initialized queue is empty.
+  // Sites are copied into their slots, since temporary sites don't outlive the failing assertion.
+  struct queued_soft_failure final {
+    std::atomic<std::size_t> sequence{ };
+    const char* file_name{ };
+    std::uint_least32_t line{ };
+    std::uint_least32_t id{ };
+    const char* function_name{ };
+    const char* expression{ };
+    megatech::soft_assertion_counter* counter{ };
+    const char* error{ };
+    bool has_message{ };
+    std::array<char, 256> message{ };
+  };
+
+  enum class soft_reporter_state {
+    unstarted,
+    starting,
+    running,
+    stopped
+  };
+
+  static std::array<queued_soft_failure, CONFIG_SOFT_ASSERTION_QUEUE_SIZE> sg_soft_queue{ };
+  static std::atomic<std::size_t> sg_soft_queue_claimed{ 0 };
+  static std::atomic<std::size_t> sg_soft_queue_reported{ 0 };
+  static std::atomic<std::uint_least64_t> sg_soft_queue_dropped{ 0 };
+  // The reporter waits on this counter. Producers only make a system call to wake it when it's actually waiting.
+  static std::atomic<std::uint32_t> sg_soft_queue_pushes{ 0 };
+  static std::atomic<soft_reporter_state> sg_soft_reporter_state{ soft_reporter_state::unstarted };
+  static std::atomic<bool> sg_soft_reporter_stopping{ false };
+  static std::thread sg_soft_reporter{ };
+  static thread_local bool pt_soft_reporter{ false };
+
+  // The first position that a slot can be claimed for during the current pass over the queue.
+  std::size_t soft_queue_lap(const std::size_t position) noexcept {
+    return position - position % sg_soft_queue.size();
+  }
+
+  // Claim a slot in the queue. This returns nullptr if the queue is full.
+  queued_soft_failure* claim_queued_soft_failure(std::size_t& position) noexcept {
+    position = sg_soft_queue_claimed.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      auto& slot = sg_soft_queue[position % sg_soft_queue.size()];
+      const auto sequence = slot.sequence.load(std::memory_order_acquire);
+      const auto difference = static_cast<std::ptrdiff_t>(sequence - soft_queue_lap(position));
+      if (!difference)
+      {
+        if (sg_soft_queue_claimed.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+        {
+          return &slot;
+        }
+      }
+      else if (difference < 0)
+      {
+        // The reporter hasn't finished with this slot's previous failure.
+        return nullptr;
+      }
+      else
+      {
+        position = sg_soft_queue_claimed.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Write the number of failures dropped since the last call. Like the failure summary, this is only written when
+  // failures are going to standard error.
+  void write_dropped_soft_failures(std::uint_least64_t& reported) noexcept {
+    const auto dropped = sg_soft_queue_dropped.load(std::memory_order_relaxed);
+    if (dropped == reported ||
+        sg_failure_handler.load(std::memory_order_acquire) != megatech::default_assertion_failure_handler)
+    {
+      return;
+    }
+    auto report = assertion_report{ };
+    report.append("Dropped soft assertion failures: ");
+    report.append_count(dropped - reported, 0);
+    reported = dropped;
+    report.append("\n");
+    report.write();
+  }
+
+  // The body of the reporter thread. Every failure that's ready is reported before the reporter waits again.
+  void report_queued_soft_failures() noexcept {
+    pt_soft_reporter = true;
+    auto position = std::size_t{ 0 };
+    auto dropped = std::uint_least64_t{ 0 };
+    for (;;)
+    {
+      // Stopping is always followed by a push, so a stop is never missed.
+      const auto pushes = sg_soft_queue_pushes.load(std::memory_order_acquire);
+      const auto stopping = sg_soft_reporter_stopping.load(std::memory_order_acquire);
+      for (;;)
+      {
+        auto& slot = sg_soft_queue[position % sg_soft_queue.size()];
+        if (slot.sequence.load(std::memory_order_acquire) != soft_queue_lap(position) + 1)
+        {
+          break;
+        }
+        const auto site = megatech::assertion_site{ slot.file_name, slot.line, slot.function_name, slot.expression,
+                                                    nullptr, slot.counter, true, slot.id };
+        const auto failure = megatech::assertion_failure{ &site, slot.has_message ? slot.message.data() : nullptr,
+                                                          slot.error, true };
+        deliver_assertion_failure(failure);
+        slot.sequence.store(soft_queue_lap(position) + sg_soft_queue.size(), std::memory_order_release);
+        sg_soft_queue_reported.store(++position, std::memory_order_release);
+      }
+      write_dropped_soft_failures(dropped);
+      if (stopping)
+      {
+        return;
+      }
+      sg_soft_queue_pushes.wait(pushes, std::memory_order_acquire);
+    }
+  }
+
+  // Stop the reporter at exit, after it reports every queued failure.
+  void stop_soft_assertion_reporter() noexcept {
+    sg_soft_reporter_state.store(soft_reporter_state::stopped, std::memory_order_release);
+    sg_soft_reporter_stopping.store(true, std::memory_order_release);
+    sg_soft_queue_pushes.fetch_add(1, std::memory_order_release);
+    sg_soft_queue_pushes.notify_one();
+    if (pt_soft_reporter)
+    {
+      sg_soft_reporter.detach();
+    }
+    else
+    {
+      sg_soft_reporter.join();
+    }
+  }
+
+  // Start the reporter when the first failure is queued. If it can't be started, failures are reported on the failing
+  // thread instead.
+  soft_reporter_state start_soft_assertion_reporter() noexcept {
+    auto expected = soft_reporter_state::unstarted;
+    if (!sg_soft_reporter_state.compare_exchange_strong(expected, soft_reporter_state::starting,
+                                                        std::memory_order_acq_rel))
+    {
+      return expected;
+    }
+#ifdef __cpp_exceptions
+    try
+    {
+      sg_soft_reporter = std::thread{ report_queued_soft_failures };
+    }
+    catch (...)
+    {
+      sg_soft_reporter_state.store(soft_reporter_state::stopped, std::memory_order_release);
+      return soft_reporter_state::stopped;
+    }
+#else
+    sg_soft_reporter = std::thread{ report_queued_soft_failures };
+#endif
+    if (std::atexit(stop_soft_assertion_reporter))
+    {
+      sg_soft_reporter.detach();
+    }
+    sg_soft_reporter_state.store(soft_reporter_state::running, std::memory_order_release);
+    return soft_reporter_state::running;
+  }
+
+  // Queue a soft failure for the reporter. If this returns false, the failure must be reported by the caller.
+  bool queue_soft_assertion_failure(const megatech::assertion_site& site, const char* message,
+                                    const char* error) noexcept {
+    auto state = sg_soft_reporter_state.load(std::memory_order_acquire);
+    if (state == soft_reporter_state::unstarted)
+    {
+      state = start_soft_assertion_reporter();
+    }
+    if (state == soft_reporter_state::stopped)
+    {
+      return false;
+    }
+    auto position = std::size_t{ 0 };
+    const auto slot = claim_queued_soft_failure(position);
+    if (!slot)
+    {
+      sg_soft_queue_dropped.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+    slot->file_name = site.file_name;
+    slot->line = site.line;
+    slot->id = site.id;
+    slot->function_name = site.function_name;
+    slot->expression = site.expression;
+    slot->counter = site.counter;
+    slot->error = error;
+    slot->has_message = message && !error;
+    if (slot->has_message)
+    {
+      // Long messages are truncated.
+      auto i = std::size_t{ 0 };
+      for (; message[i] && i < slot->message.size() - 1; ++i)
+      {
+        slot->message[i] = message[i];
+      }
+      slot->message[i] = '\0';
+    }
+    slot->sequence.store(soft_queue_lap(position) + 1, std::memory_order_release);
+    sg_soft_queue_pushes.fetch_add(1, std::memory_order_release);
+    sg_soft_queue_pushes.notify_one();
+    return true;
+  }
+
+  // Wait until every failure queued before the call has been reported, but never longer than the drain timeout.
+  void flush_soft_assertion_queue() noexcept {
+    const auto state = sg_soft_reporter_state.load(std::memory_order_acquire);
+    if (pt_soft_reporter || state == soft_reporter_state::unstarted || state == soft_reporter_state::stopped)
+    {
+      return;
+    }
+    const auto claimed = sg_soft_queue_claimed.load(std::memory_order_acquire);
+    for (auto i = 0; i < drain_timeout_polls && sg_soft_queue_reported.load(std::memory_order_acquire) < claimed; ++i)
+    {
+      pause_briefly();
+    }
+  }
+#endif
+
+  // Profiles are pushed onto a lock-free list as they're claimed, and they're never removed. The report is registered
+  // to run at exit when the first profile is claimed.
+  static std::atomic<megatech::assertion_profile*> sg_assertion_profiles{ nullptr };
+  static std::atomic_flag sg_assertion_profile_report_registered{ };
+
+  // A profile for sites whose profile couldn't be allocated. Its counts are never reported.
+  MEGATECH_ASSERTIONS_PT_DECL megatech::assertion_profile pt_unlisted_assertion_profile{ };
+
+#ifdef CONFIG_FREESTANDING
+  // Freestanding builds have no heap, so profiles are claimed from a fixed pool instead.
+  constexpr auto static_assertion_profile_count = std::size_t{ 64 };
+
+  static std::array<megatech::assertion_profile, static_assertion_profile_count> sg_static_assertion_profiles{ };
+  static std::atomic<std::size_t> sg_static_assertion_profiles_claimed{ 0 };
+#endif
+
+  void write_assertion_profile_at_exit() noexcept {
+    megatech::write_assertion_profile();
+  }
+
+  // Begin processing an assertion failure. If this returns true, the caller should write a report.
+  bool begin_assertion_failure([[maybe_unused]] const megatech::assertion_site& site) noexcept {
+#ifndef CONFIG_FREESTANDING
+    // Trapped failures never abort, so they don't take part in draining.
+    if (pt_assertion_failure_trap)
+    {
+      return true;
+    }
+#endif
+#ifdef CONFIG_THREAD_SAFE_ASSERTIONS_ENABLED
+    // Nested failures always report. They don't take a ticket because they abort immediately.
+    if (pt_failure_depth++)
+    {
+      return true;
+    }
+    if (sg_failures.fetch_add(1, std::memory_order_acq_rel) <= CONFIG_ASSERTION_DRAIN_LIMIT)
+    {
+      return true;
+    }
+    count_suppressed_failure(site);
+    return false;
+#else
+    return true;
+#endif
+  }
+
+  // Finish processing an assertion failure. This waits for other reports to drain and then aborts the program.
+  [[noreturn]] void end_assertion_failure(const bool reported) noexcept {
+#ifdef CONFIG_THREAD_SAFE_ASSERTIONS_ENABLED
+    if (pt_failure_depth > 1)
+    {
+      abort_program();
+    }
+    if (reported)
+    {
+      sg_resolved.fetch_add(1, std::memory_order_acq_rel);
+    }
+    constexpr auto limit = std::size_t{ CONFIG_ASSERTION_DRAIN_LIMIT } + 1;
+    auto previous = std::size_t{ 0 };
+    auto quiet = 0;
+    for (auto i = 0; i < drain_timeout_polls && quiet < drain_quiet_polls; ++i)
+    {
+      const auto failures = sg_failures.load(std::memory_order_acquire);
+      const auto expected = failures < limit ? failures : limit;
+      if (failures == previous && sg_resolved.load(std::memory_order_acquire) >= expected)
+      {
+        ++quiet;
+      }
+      else
+      {
+        quiet = 0;
+      }
+      previous = failures;
+      pause_briefly();
+    }
+    // Only one thread writes the summary. The others wait for it, but never longer than the drain timeout.
+    if (!sg_summary_claimed.test_and_set(std::memory_order_acq_rel))
+    {
+      write_suppressed_failure_summary();
+      sg_summary_written.test_and_set(std::memory_order_release);
+    }
+    for (auto i = 0; i < drain_timeout_polls && !sg_summary_written.test(std::memory_order_acquire); ++i)
+    {
+      pause_briefly();
+    }
+#ifdef MEGATECH_ASSERTIONS_SOFT_QUEUE_ENABLED
+    // Soft failures that happened before this one are reported before the program aborts.
+    flush_soft_assertion_queue();
+#endif
+#else
+    (void) reported;
+#endif
+    abort_program();
+  }
+
+  // Match a string against a glob pattern. "*" matches any sequence of characters and "?" matches any single
+  // character. This backtracks to the most recent "*" on a mismatch, so it never needs more than constant space.
+  bool glob_matches(const std::string_view pattern, const char* text) noexcept {
+    if (!text)
+    {
+      return false;
+    }
+    auto p = std::size_t{ 0 };
+    auto star = std::string_view::npos;
+    auto retry = text;
+    while (*text)
+    {
+      if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == *text))
+      {
+        ++p;
+        ++text;
+      }
+      else if (p < pattern.size() && pattern[p] == '*')
+      {
+        star = p++;
+        retry = text;
+      }
+      else if (star != std::string_view::npos)
+      {
+        p = star + 1;
+        text = ++retry;
+      }
+      else
+      {
+        return false;
+      }
+    }
+    while (p < pattern.size() && pattern[p] == '*')
+    {
+      ++p;
+    }
+    return p == pattern.size();
+  }
+
+  // Count a soft assertion failure and determine whether or not it should be reported. The counter is the only shared
+  // state touched here, so many threads can fail simultaneously without serializing.
+  bool count_soft_assertion_failure(const megatech::assertion_site& site) noexcept {
+    if (!site.counter)
+    {
+      return true;
+    }
+    [[maybe_unused]] const auto previous = site.counter->failures.fetch_add(1, std::memory_order_relaxed);
+#ifndef CONFIG_FREESTANDING
+    megatech::internal::base::publish_assertion_failures(site, previous + 1);
+#endif
+#if CONFIG_SOFT_ASSERTION_REPORT_LIMIT
+    return previous < CONFIG_SOFT_ASSERTION_REPORT_LIMIT;
+#else
+    return false;
+#endif
+  }
+
+  // Report a soft assertion failure. Soft assertions don't participate in the failure protocol.
+  void report_soft_assertion_failure(const megatech::assertion_site& site, const char* message,
+                                     const char* error) noexcept {
+#ifdef MEGATECH_ASSERTIONS_SOFT_QUEUE_ENABLED
+    if (queue_soft_assertion_failure(site, message, error))
+    {
+      return;
+    }
+#endif
+    handle_assertion_failure(site, true, message, error);
+  }
+
+#ifdef MEGATECH_ASSERTIONS_FORMAT_AVAILABLE
+  using megatech::internal::base::deferred_argument_type;
+  using megatech::internal::base::deferred_argument_limit;
+
+  // A single decoded deferred argument. Formatting is forwarded to the standard formatter for the decoded type.
+  struct deferred_value final {
+    deferred_argument_type type{ deferred_argument_type::pointer };
+    union {
+      bool boolean;
+      char character;
+      long long signed_integer;
+      unsigned long long unsigned_integer;
+      float single_floating_point;
+      double floating_point;
+      long double long_floating_point;
+      const char* string;
+      std::string_view string_view;
+      const void* pointer{ nullptr };
+    };
+  };
+
+  using deferred_values = std::array<deferred_value, deferred_argument_limit>;
+
+  template <typename Type>
+  Type read_deferred_payload(const std::byte*& position) noexcept {
+    auto payload = Type{ };
+    std::memcpy(&payload, position, sizeof(Type));
+    position += sizeof(Type);
+    return payload;
+  }
+
+  // Decode a deferred argument encoding. Any unused values are null pointers.
+  void decode_deferred_arguments(const std::byte* arguments, const std::size_t size, deferred_values& values) noexcept {
+    const auto end = arguments + size;
+    for (auto& value : values)
+    {
+      if (arguments == end)
+      {
+        break;
+      }
+      value.type = static_cast<deferred_argument_type>(*arguments++);
+      switch (value.type)
+      {
+      case deferred_argument_type::boolean:
+        value.boolean = read_deferred_payload<bool>(arguments);
+        break;
+      case deferred_argument_type::character:
+        value.character = read_deferred_payload<char>(arguments);
+        break;
+      case deferred_argument_type::signed_integer:
+        value.signed_integer = read_deferred_payload<long long>(arguments);
+        break;
+      case deferred_argument_type::unsigned_integer:
+        value.unsigned_integer = read_deferred_payload<unsigned long long>(arguments);
+        break;
+      case deferred_argument_type::single_floating_point:
+        value.single_floating_point = read_deferred_payload<float>(arguments);
+        break;
+      case deferred_argument_type::floating_point:
+        value.floating_point = read_deferred_payload<double>(arguments);
+        break;
+      case deferred_argument_type::long_floating_point:
+        value.long_floating_point = read_deferred_payload<long double>(arguments);
+        break;
+      case deferred_argument_type::string:
+        value.string = read_deferred_payload<const char*>(arguments);
+        break;
+      case deferred_argument_type::string_view:
+        value.string_view = read_deferred_payload<std::string_view>(arguments);
+        break;
+      case deferred_argument_type::pointer:
+        value.pointer = read_deferred_payload<const void*>(arguments);
+        break;
+      }
+    }
+  }
+#endif
+
+}
+
+#ifdef MEGATECH_ASSERTIONS_FORMAT_AVAILABLE
+// Deferred values keep their format specification and forward it to the formatter of the decoded type. Every format
+// is parsed at run-time, so this doesn't need to be usable in constant expressions.
+template <>
+struct std::formatter<deferred_value> {
+  std::string_view specification{ };
+
+  std::format_parse_context::iterator parse(std::format_parse_context& ctx) {
+    auto end = ctx.begin();
+    while (end != ctx.end() && *end != '}')
+    {
+      ++end;
+    }
+    specification = std::string_view{ ctx.begin(), static_cast<std::size_t>(end - ctx.begin()) };
+    return end;
+  }
+
+  template <typename Type, typename Context>
+  typename Context::iterator forward(const Type value, Context& ctx) const {
+    auto formatter = std::formatter<Type>{ };
+    auto parse_ctx = std::format_parse_context{ specification };
+    parse_ctx.advance_to(formatter.parse(parse_ctx));
+    return formatter.format(value, ctx);
+  }
+
+  template <typename Context>
+  typename Context::iterator format(const deferred_value& value, Context& ctx) const {
+    switch (value.type)
+    {
+    case deferred_argument_type::boolean:
+      return forward(value.boolean, ctx);
+    case deferred_argument_type::character:
+      return forward(value.character, ctx);
+    case deferred_argument_type::signed_integer:
+      return forward(value.signed_integer, ctx);
+    case deferred_argument_type::unsigned_integer:
+      return forward(value.unsigned_integer, ctx);
+    case deferred_argument_type::single_floating_point:
+      return forward(value.single_floating_point, ctx);
+    case deferred_argument_type::floating_point:
+      return forward(value.floating_point, ctx);
+    case deferred_argument_type::long_floating_point:
+      return forward(value.long_floating_point, ctx);
+    case deferred_argument_type::string:
+      return forward(value.string, ctx);
+    case deferred_argument_type::string_view:
+      return forward(value.string_view, ctx);
+    case deferred_argument_type::pointer:
+      break;
+    }
+    return forward(value.pointer, ctx);
+  }
+};
+
+namespace {
+
+  template <std::size_t... Indices>
+  auto make_deferred_format_args(deferred_values& values, std::index_sequence<Indices...>) {
+    return std::make_format_args(values[Indices]...);
+  }
+
+}
+#endif
+
+namespace {
+
+  // Write the failing thread's context scopes, outermost first. Each description is only formatted here.
+  void write_assertion_context([[maybe_unused]] const megatech::assertion_failure& failure) noexcept {
+#ifdef MEGATECH_ASSERTIONS_FORMAT_AVAILABLE
+    if (!failure.contexts || !failure.context_depth)
+    {
+      return;
+    }
+    auto header = assertion_report{ };
+    header.append("Assertion context:\n");
+    header.write();
+    const auto recorded = std::min(failure.context_depth, megatech::assertion_context_capacity);
+    for (auto i = std::size_t{ 0 }; i < recorded; ++i)
+    {
+      const auto& context = *failure.contexts[i];
+      auto description = std::array<char, 256>{ };
+      auto values = deferred_values{ };
+      decode_deferred_arguments(context.arguments, context.size, values);
+      auto store = make_deferred_format_args(values, std::make_index_sequence<deferred_argument_limit>{ });
+      const auto render = [&]() {
+        const auto end = std::vformat_to(truncating_iterator<char>{ description.data(), description.size() - 1 },
+                                         context.format, std::format_args{ store });
+        description[end.position()] = '\0';
+      };
+#ifdef __cpp_exceptions
+      try
+      {
+        render();
+      }
+      catch (...)
+      {
+        std::strcpy(description.data(), "(A formatting error occurred.)");
+      }
+#else
+      render();
+#endif
+      auto report = assertion_report{ };
+      report.append("  ");
+      report.append(description.data());
+      report.append("\n");
+      report.write();
+    }
+    if (failure.context_depth > recorded)
+    {
+      auto report = assertion_report{ };
+      report.append("  (");
+      report.append(static_cast<std::uint_least32_t>(failure.context_depth - recorded));
+      report.append(" more)\n");
+      report.write();
+    }
+#endif
+  }
+
+}
+
+namespace megatech {
+
+  std::size_t set_assertions_enabled(const std::span<const assertion_site> sites, const std::string_view pattern,
+                                     const bool enabled) noexcept {
+    auto matched = std::size_t{ 0 };
+    for (const auto& site : sites)
+    {
+      if (glob_matches(pattern, site.file_name) || glob_matches(pattern, site.function_name))
+      {
+        site.enabled.store(enabled, std::memory_order_relaxed);
+        ++matched;
+      }
+    }
+    return matched;
+  }
+
+  void default_assertion_failure_handler(const assertion_failure& failure) noexcept {
+    write_assertion_report(failure);
+    write_assertion_context(failure);
+    write_backtrace(failure);
+  }
+
+  assertion_failure_handler set_assertion_failure_handler(const assertion_failure_handler handler) noexcept {
+    return sg_failure_handler.exchange(handler ? handler : DEFAULT_FAILURE_HANDLER, std::memory_order_acq_rel);
+  }
+
+  assertion_failure_handler get_assertion_failure_handler() noexcept {
+    return sg_failure_handler.load(std::memory_order_acquire);
+  }
+
+  void configure_assertions(const std::span<const assertion_site> sites, const char* specification) noexcept {
+    if (!specification)
+    {
+      return;
+    }
+    auto remaining = std::string_view{ specification };
+    while (!remaining.empty())
+    {
+      // std::string_view::substr() may throw, so the specification is split without it.
+      const auto end = std::min(remaining.find(','), remaining.size());
+      auto pattern = std::string_view{ remaining.data(), end };
+      remaining.remove_prefix(std::min(end + 1, remaining.size()));
+      auto enabled = true;
+      if (pattern.starts_with('-') || pattern.starts_with('+'))
+      {
+        enabled = pattern.front() == '+';
+        pattern.remove_prefix(1);
+      }
+      if (!pattern.empty())
+      {
+        set_assertions_enabled(sites, pattern, enabled);
+      }
+    }
+  }
+
+  std::uint_least64_t dropped_soft_assertion_failures() noexcept {
+#ifdef MEGATECH_ASSERTIONS_SOFT_QUEUE_ENABLED
+    return sg_soft_queue_dropped.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+  }
+
+  void flush_soft_assertion_failures() noexcept {
+#ifdef MEGATECH_ASSERTIONS_SOFT_QUEUE_ENABLED
+    flush_soft_assertion_queue();
+#endif
+  }
+
+  const assertion_profile* assertion_profiles() noexcept {
+    return sg_assertion_profiles.load(std::memory_order_acquire);
+  }
+
+  void write_assertion_profile() noexcept {
+#ifndef CONFIG_FREESTANDING
+    struct site_profile final {
+      const assertion_site* site{ };
+      std::uint_least64_t evaluations{ };
+      std::uint_least64_t cycles{ };
+    };
+#ifdef __cpp_exceptions
+    try
+#endif
+    {
+      auto profiles = std::vector<site_profile>{ };
+      for (auto profile = assertion_profiles(); profile; profile = profile->next)
+      {
+        profiles.push_back(site_profile{ profile->site, profile->evaluations.load(std::memory_order_relaxed),
+                                         profile->cycles.load(std::memory_order_relaxed) });
+      }
+      // Combine the profiles of every thread that evaluated the same site.
+      std::sort(profiles.begin(), profiles.end(), [](const auto& a, const auto& b) { return a.site < b.site; });
+      auto combined = std::size_t{ 0 };
+      for (auto i = std::size_t{ 1 }; i < profiles.size(); ++i)
+      {
+        if (profiles[i].site == profiles[combined].site)
+        {
+          profiles[combined].evaluations += profiles[i].evaluations;
+          profiles[combined].cycles += profiles[i].cycles;
+        }
+        else
+        {
+          profiles[++combined] = profiles[i];
+        }
+      }
+      profiles.resize(std::min(profiles.size(), combined + 1));
+      const auto timed = std::any_of(profiles.begin(), profiles.end(), [](const auto& p) { return p.cycles; });
+      std::sort(profiles.begin(), profiles.end(), [timed](const auto& a, const auto& b) {
+        return timed ? a.cycles > b.cycles : a.evaluations > b.evaluations;
+      });
+      auto header = assertion_report{ };
+      header.append("Assertion profile:\n              cycles          evaluations  site\n");
+      header.write();
+      for (const auto& profile : profiles)
+      {
+        auto counts = std::array<char, 48>{ };
+        std::snprintf(counts.data(), counts.size(), "%20" PRIuLEAST64 " %20" PRIuLEAST64 "  ", profile.cycles,
+                      profile.evaluations);
+        auto report = assertion_report{ };
+        report.append(counts.data());
+        append_site_location(report, *profile.site);
+        if (profile.site->expression)
+        {
+          report.append(": \"");
+          report.append(profile.site->expression);
+          report.append("\"");
+        }
+        report.append("\n");
+        report.write();
+      }
+    }
+#ifdef __cpp_exceptions
+    catch (...)
+    {
+      // The report is best effort. If it can't be assembled, nothing is written.
+    }
+#endif
+#endif
+  }
+
+}
+
+namespace megatech::internal::base {
+
+  void apply_environment_assertion_toggles([[maybe_unused]] const std::span<const assertion_site> sites) noexcept {
+#ifndef CONFIG_FREESTANDING
+    configure_assertions(sites, std::getenv("MEGATECH_ASSERTIONS_TOGGLES"));
+#endif
+  }
+
+#ifndef CONFIG_FREESTANDING
+  void push_assertion_failure_trap(assertion_failure_trap& trap) noexcept {
+    trap.previous = pt_assertion_failure_trap;
+    trap.context_depth = pt_assertion_contexts.depth;
+    pt_assertion_failure_trap = &trap;
+  }
+
+  void pop_assertion_failure_trap(assertion_failure_trap& trap) noexcept {
+    pt_assertion_failure_trap = trap.previous;
+  }
+#endif
+
+  assertion_profile* claim_assertion_profile(const assertion_site& site) noexcept {
+#ifdef CONFIG_FREESTANDING
+    const auto index = sg_static_assertion_profiles_claimed.fetch_add(1, std::memory_order_relaxed);
+    if (index >= sg_static_assertion_profiles.size())
+    {
+      return &pt_unlisted_assertion_profile;
+    }
+    const auto profile = &sg_static_assertion_profiles[index];
+    profile->site = &site;
+#else
+    const auto profile = new (std::nothrow) assertion_profile{ &site };
+    if (!profile)
+    {
+      return &pt_unlisted_assertion_profile;
+    }
+#endif
+    auto next = sg_assertion_profiles.load(std::memory_order_relaxed);
+    do
+    {
+      profile->next = next;
+    }
+    while (!sg_assertion_profiles.compare_exchange_weak(next, profile, std::memory_order_release,
+                                                       std::memory_order_relaxed));
+    if (!sg_assertion_profile_report_registered.test_and_set(std::memory_order_relaxed))
+    {
+      std::atexit(write_assertion_profile_at_exit);
+    }
+    return profile;
+  }
+
+#if CONFIG_ASSERTION_BUFFER_CHAR_SIZE
+  void dispatch_assertion_failure_with_message(const assertion_site& site, const char* message) noexcept {
+    const auto reporting = begin_assertion_failure(site);
+    if (reporting)
+    {
+      handle_assertion_failure(site, false, message ? message : "", nullptr);
+    }
+    end_assertion_failure(reporting);
+  }
+#endif
+
+  void dispatch_assertion_failure(const assertion_site& site) noexcept {
+    const auto reporting = begin_assertion_failure(site);
+    if (reporting)
+    {
+      handle_assertion_failure(site, false, nullptr, nullptr);
+    }
+    end_assertion_failure(reporting);
+  }
+
+  void dispatch_assertion_failure_with_error(const assertion_site& site, const char* error) noexcept {
+    handle_assertion_failure(site, false, nullptr, error ? error : "");
+    abort_program();
+  }
+
+  void dispatch_assertion_failure_printf(const assertion_site* site, ...) noexcept {
+    const auto reporting = begin_assertion_failure(*site);
+    // Threads that won't report don't need to format anything.
+    if (reporting)
+    {
+#if CONFIG_ASSERTION_BUFFER_CHAR_SIZE
+      auto buffer = assertion_buffer_claim{ };
+      std::va_list args;
+      va_start(args, site);
+      const auto error = render_message(buffer, site->format, args);
+      va_end(args);
+      if (error == no_buffer_error)
+      {
+        handle_assertion_failure(*site, false, nullptr, error);
+        end_assertion_failure(reporting);
+      }
+      if (error)
+      {
+        dispatch_assertion_failure_with_error(*site, error);
+      }
+      handle_assertion_failure(*site, false, buffer.data(), nullptr);
+#else
+      handle_assertion_failure(*site, false, nullptr, nullptr);
+#endif
+    }
+    end_assertion_failure(reporting);
+  }
+
+#ifdef MEGATECH_ASSERTIONS_FORMAT_AVAILABLE
+  void dispatch_assertion_failure_format(const assertion_site& site, std::format_args&& args) noexcept {
+    const auto reporting = begin_assertion_failure(site);
+    if (reporting)
+    {
+// If the assertion buffer is disabled, immediately defer to a bufferless assertion.
+#if CONFIG_ASSERTION_BUFFER_CHAR_SIZE
+      auto buffer = assertion_buffer_claim{ };
+      const auto error = render_message(buffer, site.format, args);
+      if (error == no_buffer_error)
+      {
+        handle_assertion_failure(site, false, nullptr, error);
+        end_assertion_failure(reporting);
+      }
+      if (error)
+      {
+        dispatch_assertion_failure_with_error(site, error);
+      }
+      handle_assertion_failure(site, false, buffer.data(), nullptr);
+#else
+      (void) args;
+      handle_assertion_failure(site, false, nullptr, nullptr);
+#endif
+    }
+    end_assertion_failure(reporting);
+  }
+#endif
+
+  void dispatch_soft_assertion_failure(const assertion_site& site) noexcept {
+    if (count_soft_assertion_failure(site))
+    {
+      report_soft_assertion_failure(site, nullptr, nullptr);
+    }
+  }
+
+  void dispatch_soft_assertion_failure_printf(const assertion_site* site, ...) noexcept {
+    if (!count_soft_assertion_failure(*site))
+    {
+      return;
+    }
+#if CONFIG_ASSERTION_BUFFER_CHAR_SIZE
+    auto buffer = assertion_buffer_claim{ };
+    std::va_list args;
+    va_start(args, site);
+    const auto error = render_message(buffer, site->format, args);
+    va_end(args);
+    report_soft_assertion_failure(*site, error ? nullptr : buffer.data(), error);
+#else
+    report_soft_assertion_failure(*site, nullptr, nullptr);
+#endif
+  }
+
+#ifdef MEGATECH_ASSERTIONS_FORMAT_AVAILABLE
+  void dispatch_soft_assertion_failure_format(const assertion_site& site, std::format_args&& args) noexcept {
+    if (!count_soft_assertion_failure(site))
+    {
+      return;
+    }
+#if CONFIG_ASSERTION_BUFFER_CHAR_SIZE
+    auto buffer = assertion_buffer_claim{ };
+    const auto error = render_message(buffer, site.format, args);
+    report_soft_assertion_failure(site, error ? nullptr : buffer.data(), error);
+#else
+    (void) args;
+    report_soft_assertion_failure(site, nullptr, nullptr);
+#endif
+  }
+
+  void dispatch_assertion_failure_deferred(const assertion_site& site, const std::byte* arguments,
+                                           const std::size_t size) noexcept {
+    auto values = deferred_values{ };
+    decode_deferred_arguments(arguments, size, values);
+    auto store = make_deferred_format_args(values, std::make_index_sequence<deferred_argument_limit>{ });
+    dispatch_assertion_failure_format(site, std::format_args{ store });
+  }
+
+  void dispatch_soft_assertion_failure_deferred(const assertion_site& site, const std::byte* arguments,
+                                                const std::size_t size) noexcept {
+    auto values = deferred_values{ };
+    decode_deferred_arguments(arguments, size, values);
+    auto store = make_deferred_format_args(values, std::make_index_sequence<deferred_argument_limit>{ });
+    dispatch_soft_assertion_failure_format(site, std::format_args{ store });
+  }
+#endif
 
 }
@@ -0,0 +1,44 @@
+/**
+ * @file assertions.cppm
+ * @brief megatech.assertions Module Interface
+ * @details This exports everything declared by `megatech/assertions.hpp`. Macros can't be exported, so importers
+ *          include `megatech/assertions/module.hpp` to use the assertion macros.
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2024
+ */
+module;
+
+// Standard headers are included in the global module fragment so that they aren't attached to this module.
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <initializer_list>
+#include <source_location>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<format>) && !defined(MEGATECH_ASSERTIONS_FORMAT_UNAVAILABLE)
+  #include <format>
+#endif
+
+#if defined(MEGATECH_ASSERTIONS_PROFILE_CYCLES)
+  #if defined(__i386__) || defined(__x86_64__)
+    #include <x86intrin.h>
+  #else
+    #include <chrono>
+  #endif
+#endif
+
+export module megatech.assertions;
+
+// The library is still compiled as ordinary C++, so exported declarations keep their usual linkage.
+export extern "C++" {
+#include <megatech/assertions.hpp>
+}
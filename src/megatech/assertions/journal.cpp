@@ -0,0 +1,163 @@
+/**
+ * @file journal.cpp
+ * @brief Assertion Failure Journal Implementation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2024
+ */
+#include "megatech/assertions/journal.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+
+#include <atomic>
+#include <new>
+#include <type_traits>
+
+// Journals are shared file mappings. Stores into the mapping reach the page cache immediately, so the kernel writes
+// them back even if the process is killed before it can flush anything.
+#if __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && __has_include(<fcntl.h>) && \
+    __has_include(<unistd.h>) && __has_include(<pthread.h>)
+  #define MEGATECH_ASSERTIONS_JOURNAL_AVAILABLE (1)
+
+  #include <ctime>
+
+  #include <fcntl.h>
+  #include <pthread.h>
+  #include <unistd.h>
+
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+#endif
+
+namespace {
+
+  constexpr auto default_journal_capacity = std::size_t{ 64 };
+
+#ifdef MEGATECH_ASSERTIONS_JOURNAL_AVAILABLE
+  static std::atomic<megatech::assertion_journal_header*> sg_journal{ nullptr };
+
+  megatech::assertion_journal_record* journal_records(megatech::assertion_journal_header& header) noexcept {
+    return reinterpret_cast<megatech::assertion_journal_record*>(&header + 1);
+  }
+
+  // Copy a string into a fixed-size field, truncating it if necessary. A nullptr source leaves the field empty.
+  template <std::size_t Size>
+  void copy_field(std::array<char, Size>& field, const char* source) noexcept {
+    auto i = std::size_t{ 0 };
+    for (; source && source[i] && i < Size - 1; ++i)
+    {
+      field[i] = source[i];
+    }
+    field[i] = '\0';
+  }
+
+  // pthread_t is an integer on some systems and a pointer on others.
+  template <typename Thread>
+  std::uint64_t thread_identifier(const Thread thread) noexcept {
+    if constexpr (std::is_pointer_v<Thread>)
+    {
+      return reinterpret_cast<std::uintptr_t>(thread);
+    }
+    else
+    {
+      return static_cast<std::uint64_t>(thread);
+    }
+  }
+
+  bool valid_journal(const megatech::assertion_journal_header& header, const std::size_t capacity) noexcept {
+    return header.magic == megatech::assertion_journal_header::magic_value &&
+           header.version == megatech::assertion_journal_header::current_version &&
+           header.record_size == sizeof(megatech::assertion_journal_record) && header.capacity == capacity;
+  }
+#endif
+
+  // Open the journal named by MEGATECH_ASSERTIONS_JOURNAL, if any, during static initialization.
+  static const auto sg_environment_journal = []() noexcept {
+    const auto path = std::getenv("MEGATECH_ASSERTIONS_JOURNAL");
+    return path && *path && megatech::open_assertion_journal(path, default_journal_capacity);
+  }();
+
+}
+
+namespace megatech {
+
+  bool open_assertion_journal([[maybe_unused]] const char* path,
+                              [[maybe_unused]] const std::size_t capacity) noexcept {
+#ifdef MEGATECH_ASSERTIONS_JOURNAL_AVAILABLE
+    if (!path || !capacity)
+    {
+      return false;
+    }
+    const auto size = sizeof(assertion_journal_header) + capacity * sizeof(assertion_journal_record);
+    const auto fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+      return false;
+    }
+    struct stat status{ };
+    const auto reuse = !fstat(fd, &status) && static_cast<std::size_t>(status.st_size) == size;
+    if (!reuse && ftruncate(fd, static_cast<off_t>(size)))
+    {
+      close(fd);
+      return false;
+    }
+    const auto mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+      return false;
+    }
+    auto& header = *static_cast<assertion_journal_header*>(mapping);
+    if (!reuse || !valid_journal(header, capacity))
+    {
+      new (&header) assertion_journal_header{ assertion_journal_header::magic_value,
+                                              assertion_journal_header::current_version,
+                                              sizeof(assertion_journal_record), capacity, 0 };
+      const auto records = journal_records(header);
+      for (auto i = std::size_t{ 0 }; i < capacity; ++i)
+      {
+        new (&records[i]) assertion_journal_record{ };
+      }
+    }
+    sg_journal.store(&header, std::memory_order_release);
+    return true;
+#else
+    return false;
+#endif
+  }
+
+}
+
+namespace megatech::internal::base {
+
+  void journal_assertion_failure([[maybe_unused]] const assertion_failure& failure) noexcept {
+#ifdef MEGATECH_ASSERTIONS_JOURNAL_AVAILABLE
+    const auto header = sg_journal.load(std::memory_order_acquire);
+    if (!header)
+    {
+      return;
+    }
+    const auto ticket = std::atomic_ref{ header->claimed }.fetch_add(1, std::memory_order_relaxed);
+    auto& record = journal_records(*header)[ticket % header->capacity];
+    // Readers must never mistake a partially overwritten record for a complete one.
+    std::atomic_ref{ record.sequence }.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    auto now = timespec{ };
+    clock_gettime(CLOCK_REALTIME, &now);
+    const auto& site = *failure.site;
+    record.thread = thread_identifier(pthread_self());
+    record.timestamp = static_cast<std::int64_t>(now.tv_sec) * 1'000'000'000 + now.tv_nsec;
+    record.line = site.line;
+    record.id = site.id;
+    record.flags = (failure.soft ? assertion_journal_record::soft_flag : 0) |
+                   (failure.error ? assertion_journal_record::error_flag : 0);
+    copy_field(record.file_name, site.file_name);
+    copy_field(record.function_name, site.function_name);
+    copy_field(record.expression, site.expression);
+    copy_field(record.message, failure.error ? failure.error : failure.message);
+    std::atomic_ref{ record.sequence }.store(ticket + 1, std::memory_order_release);
+#endif
+  }
+
+}
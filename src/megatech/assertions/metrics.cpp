@@ -0,0 +1,250 @@
+/**
+ * @file metrics.cpp
+ * @brief Shared-Memory Assertion Metrics Implementation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2024
+ */
+#include "megatech/assertions/metrics.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+
+#include <atomic>
+#include <new>
+
+// Metrics are published in a POSIX shared-memory object, so readers can map the same pages while the process runs.
+#if __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && __has_include(<fcntl.h>) && \
+    __has_include(<unistd.h>)
+  #define MEGATECH_ASSERTIONS_METRICS_AVAILABLE (1)
+
+  #include <fcntl.h>
+  #include <unistd.h>
+
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+#endif
+
+namespace {
+
+  constexpr auto default_metrics_capacity = std::size_t{ 256 };
+
+#ifdef MEGATECH_ASSERTIONS_METRICS_AVAILABLE
+  // Writers that find a record locked retry this many times before giving up. The next update publishes the record.
+  constexpr auto lock_attempts = 64;
+
+  static std::atomic<megatech::assertion_metrics_header*> sg_metrics{ nullptr };
+
+  megatech::assertion_metrics_record* metrics_records(megatech::assertion_metrics_header& header) noexcept {
+    return reinterpret_cast<megatech::assertion_metrics_record*>(&header + 1);
+  }
+
+  // Copy a string into a fixed-size field, truncating it if necessary. A nullptr source leaves the field empty.
+  template <std::size_t Size>
+  void copy_field(std::array<char, Size>& field, const char* source) noexcept {
+    auto i = std::size_t{ 0 };
+    for (; source && source[i] && i < Size - 1; ++i)
+    {
+      field[i] = source[i];
+    }
+    field[i] = '\0';
+  }
+
+  // Find the record of a site, or claim one for it. This returns nullptr if every record is claimed by other sites.
+  // Newly claimed records are returned locked, since their names haven't been written yet.
+  megatech::assertion_metrics_record* find_metrics_record(megatech::assertion_metrics_header& header,
+                                                           const megatech::assertion_site& site,
+                                                           bool& claimed) noexcept {
+    const auto key = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(&site));
+    const auto records = metrics_records(header);
+    // Sites are at least pointer aligned, so the low bits of their addresses are discarded.
+    const auto start = static_cast<std::size_t>((key >> 3) * 0x9e3779b97f4a7c15ull % header.capacity);
+    for (auto i = std::size_t{ 0 }; i < header.capacity; ++i)
+    {
+      auto& record = records[(start + i) % header.capacity];
+      auto current = std::atomic_ref{ record.site }.load(std::memory_order_acquire);
+      if (!current)
+      {
+        // The sequence number is claimed before the site, so that no other writer can lock the record first.
+        auto sequence = std::uint64_t{ 0 };
+        if (std::atomic_ref{ record.sequence }.compare_exchange_strong(sequence, 1, std::memory_order_acquire))
+        {
+          std::atomic_ref{ record.site }.store(key, std::memory_order_release);
+          std::atomic_ref{ header.claimed }.fetch_add(1, std::memory_order_relaxed);
+          claimed = true;
+          return &record;
+        }
+        // Another writer claimed the record first. Wait for it to publish its site.
+        for (auto attempt = 0; attempt < lock_attempts && !current; ++attempt)
+        {
+          current = std::atomic_ref{ record.site }.load(std::memory_order_acquire);
+        }
+      }
+      if (current == key)
+      {
+        claimed = false;
+        return &record;
+      }
+    }
+    std::atomic_ref{ header.overflow }.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  // Lock a record by making its sequence number odd. This returns false if another writer holds the lock.
+  bool lock_metrics_record(megatech::assertion_metrics_record& record) noexcept {
+    auto lock = std::atomic_ref{ record.sequence };
+    for (auto attempt = 0; attempt < lock_attempts; ++attempt)
+    {
+      auto sequence = lock.load(std::memory_order_relaxed);
+      if (!(sequence & 1) && lock.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire))
+      {
+        // The record's fields must not be written before the odd sequence number is visible.
+        std::atomic_thread_fence(std::memory_order_release);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void unlock_metrics_record(megatech::assertion_metrics_record& record) noexcept {
+    auto lock = std::atomic_ref{ record.sequence };
+    lock.store(lock.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  // Store a counter in a locked record. Fields are written atomically, since readers may copy them concurrently.
+  void store_counter(std::uint64_t& field, const std::uint64_t value) noexcept {
+    std::atomic_ref{ field }.store(value, std::memory_order_relaxed);
+  }
+
+  // Find and lock the record of a site. This returns nullptr if the record isn't available.
+  megatech::assertion_metrics_record* lock_site_record(megatech::assertion_metrics_header& header,
+                                                        const megatech::assertion_site& site) noexcept {
+    auto claimed = false;
+    const auto record = find_metrics_record(header, site, claimed);
+    if (!record)
+    {
+      return nullptr;
+    }
+    if (claimed)
+    {
+      record->line = site.line;
+      record->id = site.id;
+      copy_field(record->file_name, site.file_name);
+      copy_field(record->function_name, site.function_name);
+      copy_field(record->expression, site.expression);
+      return record;
+    }
+    return lock_metrics_record(*record) ? record : nullptr;
+  }
+#endif
+
+  // Open the segment named by MEGATECH_ASSERTIONS_METRICS, if any, during static initialization.
+  static const auto sg_environment_metrics = []() noexcept {
+    const auto name = std::getenv("MEGATECH_ASSERTIONS_METRICS");
+    return name && *name && megatech::open_assertion_metrics(name, default_metrics_capacity);
+  }();
+
+}
+
+namespace megatech {
+
+  bool open_assertion_metrics([[maybe_unused]] const char* name, [[maybe_unused]] const std::size_t capacity) noexcept {
+#ifdef MEGATECH_ASSERTIONS_METRICS_AVAILABLE
+    if (!name || !capacity)
+    {
+      return false;
+    }
+    const auto size = sizeof(assertion_metrics_header) + capacity * sizeof(assertion_metrics_record);
+    const auto fd = shm_open(name, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+    {
+      return false;
+    }
+    // Truncating first discards the records of any previous process.
+    if (ftruncate(fd, 0) || ftruncate(fd, static_cast<off_t>(size)))
+    {
+      close(fd);
+      return false;
+    }
+    const auto mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+      return false;
+    }
+    auto& header = *new (mapping) assertion_metrics_header{ assertion_metrics_header::magic_value,
+                                                            assertion_metrics_header::current_version,
+                                                            sizeof(assertion_metrics_record), capacity, 0, 0,
+                                                            static_cast<std::uint64_t>(getpid()) };
+    const auto records = metrics_records(header);
+    for (auto i = std::size_t{ 0 }; i < capacity; ++i)
+    {
+      new (&records[i]) assertion_metrics_record{ };
+    }
+    sg_metrics.store(&header, std::memory_order_release);
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  void update_assertion_metrics([[maybe_unused]] const std::span<const assertion_site> sites) noexcept {
+#ifdef MEGATECH_ASSERTIONS_METRICS_AVAILABLE
+    const auto header = sg_metrics.load(std::memory_order_acquire);
+    if (!header)
+    {
+      return;
+    }
+    const auto profiles = assertion_profiles();
+    for (const auto& site : sites)
+    {
+      auto evaluations = std::uint64_t{ 0 };
+      auto cycles = std::uint64_t{ 0 };
+      for (auto profile = profiles; profile; profile = profile->next)
+      {
+        if (profile->site == &site)
+        {
+          evaluations += profile->evaluations.load(std::memory_order_relaxed);
+          cycles += profile->cycles.load(std::memory_order_relaxed);
+        }
+      }
+      const auto record = lock_site_record(*header, site);
+      if (!record)
+      {
+        continue;
+      }
+      store_counter(record->failures, soft_assertion_failures(site));
+      store_counter(record->evaluations, evaluations);
+      store_counter(record->cycles, cycles);
+      unlock_metrics_record(*record);
+    }
+#endif
+  }
+
+}
+
+namespace megatech::internal::base {
+
+  void publish_assertion_failures([[maybe_unused]] const assertion_site& site,
+                                  [[maybe_unused]] const std::uint_least64_t failures) noexcept {
+#ifdef MEGATECH_ASSERTIONS_METRICS_AVAILABLE
+    const auto header = sg_metrics.load(std::memory_order_acquire);
+    if (!header)
+    {
+      return;
+    }
+    const auto record = lock_site_record(*header, site);
+    if (!record)
+    {
+      return;
+    }
+    // Concurrent failures may publish out of order, so only larger counts are kept.
+    if (failures > std::atomic_ref{ record->failures }.load(std::memory_order_relaxed))
+    {
+      store_counter(record->failures, failures);
+    }
+    unlock_metrics_record(*record);
+#endif
+  }
+
+}
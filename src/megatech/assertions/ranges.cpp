@@ -0,0 +1,139 @@
+/**
+ * @file ranges.cpp
+ * @brief Run-Time Range Assertion Kernels
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2024
+ */
+#include "megatech/assertions/ranges.hpp"
+
+#include <cstdint>
+
+#include <bit>
+#include <limits>
+
+// Kernels are plain block searches. The compiler vectorizes them for the baseline instruction set (e.g., SSE2 or
+// NEON). On x86-64 ELF targets an AVX2 clone is also compiled and selected once, by the dynamic loader, when the CPU
+// supports it.
+#if defined(__x86_64__) && defined(__ELF__) && __has_cpp_attribute(gnu::target_clones)
+  #define MEGATECH_ASSERTIONS_KERNEL [[gnu::target_clones("avx2", "default")]]
+#else
+  #define MEGATECH_ASSERTIONS_KERNEL
+#endif
+
+// Helpers are always inlined so that each clone gets its own copy of the loop compiled for its instruction set.
+namespace {
+
+  // Finite values have at least one clear bit in their exponent. Testing the bits, rather than using std::isfinite,
+  // keeps the predicate in integer registers and vectorizes everywhere.
+  template <typename Type, typename Bits>
+  MEGATECH_ASSERTIONS_INLINE
+  std::size_t find_non_finite_bits(const std::span<const Type> values) noexcept {
+    constexpr auto exponent = std::bit_cast<Bits>(std::numeric_limits<Type>::infinity());
+    const auto data = values.data();
+    return megatech::internal::base::find_first_failure(0, values.size(), [data](const std::size_t i) {
+      return (std::bit_cast<Bits>(data[i]) & exponent) != exponent;
+    });
+  }
+
+  template <typename Type>
+  MEGATECH_ASSERTIONS_INLINE
+  std::size_t find_out_of_range_values(const std::span<const Type> values, const Type low, const Type high) noexcept {
+    const auto data = values.data();
+    return megatech::internal::base::find_first_failure(0, values.size(), [data, low, high](const std::size_t i) {
+      return (data[i] >= low) & (data[i] < high);
+    });
+  }
+
+  template <typename Type>
+  MEGATECH_ASSERTIONS_INLINE
+  std::size_t find_unsorted_values(const std::span<const Type> values) noexcept {
+    if (values.size() < 2)
+    {
+      return values.size();
+    }
+    const auto data = values.data();
+    return megatech::internal::base::find_first_failure(1, values.size(), [data](const std::size_t i) {
+      return !(data[i] < data[i - 1]);
+    });
+  }
+
+}
+
+namespace megatech::internal::base {
+
+  MEGATECH_ASSERTIONS_KERNEL
+  std::size_t find_non_finite(const std::span<const float> values) noexcept {
+    return find_non_finite_bits<float, std::uint32_t>(values);
+  }
+
+  MEGATECH_ASSERTIONS_KERNEL
+  std::size_t find_non_finite(const std::span<const double> values) noexcept {
+    return find_non_finite_bits<double, std::uint64_t>(values);
+  }
+
+  MEGATECH_ASSERTIONS_KERNEL
+  std::size_t find_out_of_range(const std::span<const std::int32_t> values, const std::int32_t low,
+                                const std::int32_t high) noexcept {
+    return find_out_of_range_values(values, low, high);
+  }
+
+  MEGATECH_ASSERTIONS_KERNEL
+  std::size_t find_out_of_range(const std::span<const std::uint32_t> values, const std::uint32_t low,
+                                const std::uint32_t high) noexcept {
+    return find_out_of_range_values(values, low, high);
+  }
+
+  MEGATECH_ASSERTIONS_KERNEL
+  std::size_t find_out_of_range(const std::span<const std::int64_t> values, const std::int64_t low,
+                                const std::int64_t high) noexcept {
+    return find_out_of_range_values(values, low, high);
+  }
+
+  MEGATECH_ASSERTIONS_KERNEL
+  std::size_t find_out_of_range(const std::span<const std::uint64_t> values, const std::uint64_t low,
+                                const std::uint64_t high) noexcept {
+    return find_out_of_range_values(values, low, high);
+  }
+
+  MEGATECH_ASSERTIONS_KERNEL
+  std::size_t find_out_of_range(const std::span<const float> values, const float low, const float high) noexcept {
+    return find_out_of_range_values(values, low, high);
+  }
+
+  MEGATECH_ASSERTIONS_KERNEL
+  std::size_t find_out_of_range(const std::span<const double> values, const double low, const double high) noexcept {
+    return find_out_of_range_values(values, low, high);
+  }
+
+  MEGATECH_ASSERTIONS_KERNEL
+  std::size_t find_unsorted(const std::span<const std::int32_t> values) noexcept {
+    return find_unsorted_values(values);
+  }
+
+  MEGATECH_ASSERTIONS_KERNEL
+  std::size_t find_unsorted(const std::span<const std::uint32_t> values) noexcept {
+    return find_unsorted_values(values);
+  }
+
+  MEGATECH_ASSERTIONS_KERNEL
+  std::size_t find_unsorted(const std::span<const std::int64_t> values) noexcept {
+    return find_unsorted_values(values);
+  }
+
+  MEGATECH_ASSERTIONS_KERNEL
+  std::size_t find_unsorted(const std::span<const std::uint64_t> values) noexcept {
+    return find_unsorted_values(values);
+  }
+
+  MEGATECH_ASSERTIONS_KERNEL
+  std::size_t find_unsorted(const std::span<const float> values) noexcept {
+    return find_unsorted_values(values);
+  }
+
+  MEGATECH_ASSERTIONS_KERNEL
+  std::size_t find_unsorted(const std::span<const double> values) noexcept {
+    return find_unsorted_values(values);
+  }
+
+}
@@ -0,0 +1,28 @@
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+
+#include <unistd.h>
+
+// Tests built with a write or abort function use these, so every expected report still reaches standard error.
+#ifdef CONFIG_TEST_ASSERTION_WRITE_FUNCTION
+extern "C" void CONFIG_TEST_ASSERTION_WRITE_FUNCTION(const char* data, std::size_t size) noexcept {
+  while (size)
+  {
+    const auto written = write(STDERR_FILENO, data, size);
+    if (written <= 0)
+    {
+      return;
+    }
+    data += written;
+    size -= static_cast<std::size_t>(written);
+  }
+}
+#endif
+
+#ifdef CONFIG_TEST_ASSERTION_ABORT_FUNCTION
+extern "C" [[noreturn]] void CONFIG_TEST_ASSERTION_ABORT_FUNCTION() noexcept {
+  std::abort();
+}
+#endif
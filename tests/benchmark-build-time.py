@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+
+from argparse import ArgumentParser
+from pathlib import Path
+from tempfile import TemporaryDirectory
+
+import statistics
+import subprocess
+import time
+
+REFERENCE = "<source_location> + <string_view>"
+VARIANTS = { REFERENCE: [ "-DMEGATECH_BENCHMARK_REFERENCE" ], "assertions.hpp": [ ],
+             "slim.hpp": [ "-DMEGATECH_BENCHMARK_SLIM" ] }
+
+def time_compile(command: list[str], repetitions: int) -> list[float]:
+    times = [ ]
+    for _ in range(repetitions):
+        start = time.perf_counter()
+        subprocess.run(command, check=True)
+        times.append(time.perf_counter() - start)
+    return times
+
+def main() -> None:
+    parser = ArgumentParser(description="Report the time needed to compile assertions with each header variant.")
+    parser.add_argument("--repetitions", help="The number of times to compile each variant.", type=int, default=10)
+    parser.add_argument("--module-mapper", help="The GCC module mapper that locates the megatech.assertions module.",
+                        type=Path)
+    parser.add_argument("SOURCE", help="The build time benchmark source.", type=Path)
+    parser.add_argument("INCLUDE", help="The directory containing the assertion headers.", type=Path)
+    parser.add_argument("COMPILER", help="The C++ compiler command to use.", nargs="+")
+    args = parser.parse_args()
+    variants = dict(VARIANTS)
+    if args.module_mapper:
+        variants["import megatech.assertions"] = [ "-DMEGATECH_BENCHMARK_MODULE", "-fmodules-ts",
+                                                   f"-fmodule-mapper={args.module_mapper}" ]
+    with TemporaryDirectory() as directory:
+        output = Path(directory) / "benchmark_build_time.o"
+        results = { }
+        for variant, flags in variants.items():
+            command = [ *args.COMPILER, "-std=c++20", "-UNDEBUG", f"-I{args.INCLUDE}", *flags, "-c", args.SOURCE,
+                        "-o", output ]
+            results[variant] = time_compile(command, args.repetitions)
+    baseline = statistics.mean(results["assertions.hpp"])
+    reference = statistics.mean(results[REFERENCE])
+    print(f"{'Variant':<40} {'Mean':>8} {'Min':>8} {'Relative':>9} {'Overhead':>9} (milliseconds)")
+    for variant, times in results.items():
+        mean = statistics.mean(times)
+        print(f"{variant:<40} {mean * 1000:>8.1f} {min(times) * 1000:>8.1f} {mean / baseline:>9.2f}"
+              f" {(mean - reference) * 1000:>9.1f}")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+
+from argparse import ArgumentParser
+from pathlib import Path
+
+import subprocess
+import sys
+
+SITES_PER_FUNCTION = 64
+FUNCTIONS = [ "raw_if", "assert", "assert_msg_printf", "assert_msg_format", "soft_assert" ]
+CODE_TYPES = "tTwW"
+
+def collect_sizes(nm: Path, library: Path) -> dict[str, list[int]]:
+    completed = subprocess.run([ nm, "--print-size", library ], capture_output=True, check=True)
+    # Each function has 3 sizes: hot code, cold code, and data (i.e., its assertion sites and counters).
+    sizes = { function: [ 0, 0, 0 ] for function in FUNCTIONS }
+    for line in completed.stdout.decode("utf-8").splitlines():
+        fields = line.split()
+        if len(fields) != 4:
+            continue
+        _, size, kind, name = fields
+        for function in sorted(FUNCTIONS, key=len, reverse=True):
+            # Sites are local statics, so their mangled names include the name of the enclosing function.
+            symbol = f"megatech_benchmark_{function}"
+            if symbol not in name:
+                continue
+            if kind not in CODE_TYPES:
+                sizes[function][2] += int(size, 16)
+            elif name.endswith(".cold"):
+                sizes[function][1] += int(size, 16)
+            else:
+                sizes[function][0] += int(size, 16)
+            break
+    return sizes
+
+def main() -> None:
+    parser = ArgumentParser(description="Report the code size of each assertion macro.")
+    parser.add_argument("NM", help="The nm program to use when reading symbols.", type=Path)
+    parser.add_argument("LIBRARY", help="The library containing the code size benchmark.", type=Path)
+    args = parser.parse_args()
+    sizes = collect_sizes(args.NM, args.LIBRARY)
+    baseline = sum(sizes["raw_if"][:2]) / SITES_PER_FUNCTION
+    print(f"{'Macro':<40} {'Hot':>8} {'Cold':>8} {'Data':>8} {'Overhead':>9} (bytes per site)")
+    for function, (hot, cold, data) in sizes.items():
+        if not hot:
+            continue
+        per_site = [ value / SITES_PER_FUNCTION for value in (hot, cold, data) ]
+        overhead = per_site[0] + per_site[1] - baseline
+        print(f"{function:<40} {per_site[0]:>8.2f} {per_site[1]:>8.2f} {per_site[2]:>8.2f} {overhead:>+9.2f}")
+
+if __name__ == "__main__":
+    main()
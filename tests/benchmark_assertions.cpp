@@ -0,0 +1,102 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <megatech/assertions.hpp>
+
+#include "config.hpp"
+
+// Values are read through a volatile so that the compiler can't prove any of the conditions ahead of time.
+volatile int g_limit{ 1000 };
+
+template <typename Procedure>
+double measure(const std::vector<int>& values, Procedure&& procedure) {
+  const auto limit = static_cast<int>(g_limit);
+  auto sum = 0ll;
+  const auto start = std::chrono::steady_clock::now();
+  for (auto i = 0; i < CONFIG_BENCHMARK_REPETITIONS; ++i)
+  {
+    for (const auto value : values)
+    {
+      procedure(value, limit);
+      sum += value;
+    }
+  }
+  const auto end = std::chrono::steady_clock::now();
+  if (sum < 0)
+  {
+    std::puts("unreachable");
+  }
+  const auto iterations = static_cast<double>(CONFIG_BENCHMARK_REPETITIONS) * values.size();
+  return std::chrono::duration<double, std::nano>{ end - start }.count() / iterations;
+}
+
+template <typename Procedure>
+void report(const char* name, const std::vector<int>& values, const double baseline, Procedure&& procedure) {
+  const auto result = measure(values, procedure);
+  std::printf("%-40s %8.3f ns/iteration (%+.3f ns)\n", name, result, result - baseline);
+}
+
+template <typename Procedure>
+void report_parallel(const char* name, const std::vector<int>& values, const double baseline,
+                     Procedure&& procedure) {
+  auto thread_count = std::thread::hardware_concurrency();
+  if (!thread_count)
+  {
+    thread_count = 1;
+  }
+  auto results = std::vector<double>(thread_count);
+  {
+    auto threads = std::vector<std::jthread>{ };
+    for (auto i = 0u; i < thread_count; ++i)
+    {
+      threads.emplace_back([&, i]() { results[i] = measure(values, procedure); });
+    }
+  }
+  auto worst = 0.0;
+  for (const auto result : results)
+  {
+    worst = result > worst ? result : worst;
+  }
+  std::printf("%-40s %8.3f ns/iteration (%+.3f ns) on %u threads\n", name, worst, worst - baseline, thread_count);
+}
+
+int main() {
+  const auto values = std::vector<int>(CONFIG_BENCHMARK_VALUES, 1);
+#ifdef CONFIG_TEST_THREAD_SAFE_ASSERTIONS_ENABLED
+  std::puts("Thread-safe assertions are enabled.");
+#else
+  std::puts("Thread-safe assertions are disabled.");
+#endif
+  const auto baseline = measure(values, [](const int value, const int limit) {
+    if (value >= limit) [[unlikely]]
+    {
+      std::abort();
+    }
+  });
+  std::printf("%-40s %8.3f ns/iteration\n", "Raw if", baseline);
+  report("MEGATECH_ASSERT", values, baseline, [](const int value, const int limit) {
+    MEGATECH_ASSERT(value < limit);
+  });
+  report("MEGATECH_ASSERT_MSG_PRINTF", values, baseline, [](const int value, const int limit) {
+    MEGATECH_ASSERT_MSG_PRINTF(value < limit, "%d >= %d", value, limit);
+  });
+#ifdef MEGATECH_ASSERTIONS_FORMAT_AVAILABLE
+  report("MEGATECH_ASSERT_MSG_FORMAT", values, baseline, [](const int value, const int limit) {
+    MEGATECH_ASSERT_MSG_FORMAT(value < limit, "{} >= {}", value, limit);
+  });
+#endif
+  report("MEGATECH_ASSERT_SAMPLED (n = 16)", values, baseline, [](const int value, const int limit) {
+    MEGATECH_ASSERT_SAMPLED(value < limit, 16);
+  });
+  report("MEGATECH_SOFT_ASSERT", values, baseline, [](const int value, const int limit) {
+    MEGATECH_SOFT_ASSERT(value < limit);
+  });
+  report_parallel("MEGATECH_ASSERT", values, baseline, [](const int value, const int limit) {
+    MEGATECH_ASSERT(value < limit);
+  });
+  return 0;
+}
@@ -0,0 +1,42 @@
+// The build time script compiles this once for each way of getting the assertion macros.
+#if defined(MEGATECH_BENCHMARK_MODULE)
+  #include <megatech/assertions/module.hpp>
+
+import megatech.assertions;
+#elif defined(MEGATECH_BENCHMARK_SLIM)
+  #include <megatech/assertions/slim.hpp>
+#elif defined(MEGATECH_BENCHMARK_REFERENCE)
+  // This is the floor for the other variants. It includes only what a minimal assertion needs.
+  #include <source_location>
+  #include <string_view>
+
+[[noreturn]] void megatech_benchmark_fail(std::string_view expression, std::source_location location) noexcept;
+
+  #define MEGATECH_BENCHMARK_CHECK(exp) \
+    ((exp) ? static_cast<void>(0) : megatech_benchmark_fail(#exp, std::source_location::current()))
+  #define MEGATECH_ASSERT(exp) MEGATECH_BENCHMARK_CHECK(exp)
+  #define MEGATECH_ASSERT_MSG_PRINTF(exp, ...) MEGATECH_BENCHMARK_CHECK(exp)
+  #define MEGATECH_SOFT_ASSERT(exp) MEGATECH_BENCHMARK_CHECK(exp)
+  #define MEGATECH_PRECONDITION(exp) MEGATECH_BENCHMARK_CHECK(exp)
+  #define MEGATECH_POSTCONDITION(exp) MEGATECH_BENCHMARK_CHECK(exp)
+#else
+  #include <megatech/assertions.hpp>
+#endif
+
+// Only ::MEGATECH_ASSERT and the "printf"-style macros are used, so every variant compiles the same code.
+#define MEGATECH_BENCHMARK_SITES_8(i) \
+  MEGATECH_ASSERT(values[i] != 1); MEGATECH_ASSERT(values[i] != 2); \
+  MEGATECH_ASSERT_MSG_PRINTF(values[i] != 3, "value %d", values[i]); \
+  MEGATECH_ASSERT_MSG_PRINTF(values[i] != 4, "value %d", values[i]); \
+  MEGATECH_SOFT_ASSERT(values[i] != 5); MEGATECH_SOFT_ASSERT(values[i] != 6); \
+  MEGATECH_PRECONDITION(values[i] != 7); MEGATECH_POSTCONDITION(values[i] != 8);
+
+extern "C" {
+
+  void megatech_benchmark_build_time(const int* values) {
+    MEGATECH_BENCHMARK_SITES_8(0) MEGATECH_BENCHMARK_SITES_8(1) MEGATECH_BENCHMARK_SITES_8(2)
+    MEGATECH_BENCHMARK_SITES_8(3) MEGATECH_BENCHMARK_SITES_8(4) MEGATECH_BENCHMARK_SITES_8(5)
+    MEGATECH_BENCHMARK_SITES_8(6) MEGATECH_BENCHMARK_SITES_8(7)
+  }
+
+}
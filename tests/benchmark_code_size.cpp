@@ -0,0 +1,45 @@
+#include <cstdlib>
+
+#include <megatech/assertions.hpp>
+
+// Every function contains exactly 64 sites. The code size script divides the size of each function's symbols by this
+// number. Comparing against the "raw_if" function gives the overhead of each assertion macro.
+#define MEGATECH_BENCHMARK_SITES_8(site, i) \
+  site(values[i] != 1) site(values[i] != 2) site(values[i] != 3) site(values[i] != 4) \
+  site(values[i] != 5) site(values[i] != 6) site(values[i] != 7) site(values[i] != 8)
+#define MEGATECH_BENCHMARK_SITES_64(site) \
+  MEGATECH_BENCHMARK_SITES_8(site, 0) MEGATECH_BENCHMARK_SITES_8(site, 1) MEGATECH_BENCHMARK_SITES_8(site, 2) \
+  MEGATECH_BENCHMARK_SITES_8(site, 3) MEGATECH_BENCHMARK_SITES_8(site, 4) MEGATECH_BENCHMARK_SITES_8(site, 5) \
+  MEGATECH_BENCHMARK_SITES_8(site, 6) MEGATECH_BENCHMARK_SITES_8(site, 7)
+
+#define MEGATECH_BENCHMARK_RAW_IF(exp) if (!(exp)) { std::abort(); }
+#define MEGATECH_BENCHMARK_ASSERT(exp) MEGATECH_ASSERT(exp);
+#define MEGATECH_BENCHMARK_ASSERT_MSG_PRINTF(exp) MEGATECH_ASSERT_MSG_PRINTF(exp, "value %d", values[0]);
+#define MEGATECH_BENCHMARK_ASSERT_MSG_FORMAT(exp) MEGATECH_ASSERT_MSG_FORMAT(exp, "value {}", values[0]);
+#define MEGATECH_BENCHMARK_SOFT_ASSERT(exp) MEGATECH_SOFT_ASSERT(exp);
+
+extern "C" {
+
+  void megatech_benchmark_raw_if(const int* values) {
+    MEGATECH_BENCHMARK_SITES_64(MEGATECH_BENCHMARK_RAW_IF)
+  }
+
+  void megatech_benchmark_assert(const int* values) {
+    MEGATECH_BENCHMARK_SITES_64(MEGATECH_BENCHMARK_ASSERT)
+  }
+
+  void megatech_benchmark_assert_msg_printf(const int* values) {
+    MEGATECH_BENCHMARK_SITES_64(MEGATECH_BENCHMARK_ASSERT_MSG_PRINTF)
+  }
+
+#ifdef MEGATECH_ASSERTIONS_FORMAT_AVAILABLE
+  void megatech_benchmark_assert_msg_format(const int* values) {
+    MEGATECH_BENCHMARK_SITES_64(MEGATECH_BENCHMARK_ASSERT_MSG_FORMAT)
+  }
+#endif
+
+  void megatech_benchmark_soft_assert(const int* values) {
+    MEGATECH_BENCHMARK_SITES_64(MEGATECH_BENCHMARK_SOFT_ASSERT)
+  }
+
+}
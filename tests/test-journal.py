@@ -0,0 +1,39 @@
+#!/usr/bin/env python3
+
+from argparse import ArgumentParser
+from pathlib import Path
+
+import subprocess
+import sys
+import os
+
+if os.name == "posix":
+    import resource
+
+def main() -> None:
+    if os.name == "posix":
+        try:
+            resource.setrlimit(resource.RLIMIT_CORE, (0, 0))
+        except:
+            pass
+    parser = ArgumentParser(description="Read the assertion journal written by a test program.")
+    parser.add_argument("READER", help="The journal reader to use.", type=Path)
+    parser.add_argument("PROGRAM", help="The test program to run. It receives the journal path as its argument.",
+                        type=Path)
+    parser.add_argument("JOURNAL", help="The journal file to create.", type=Path)
+    parser.add_argument("EXPECTED", nargs="*", default="", help="The output that the reader should produce.",
+                        type=str)
+    args = parser.parse_args()
+    args.JOURNAL.unlink(missing_ok=True)
+    # Nothing from the program's own output is used. Only the journal is read.
+    subprocess.run([ args.PROGRAM, args.JOURNAL ], capture_output=True)
+    completed = subprocess.run([ args.READER, args.JOURNAL ], capture_output=True)
+    output = completed.stdout.decode("utf-8")
+    for text in args.EXPECTED:
+        if completed.returncode != 0 or text not in output:
+            print(f"\"{text}\" was not in \"{output.strip()}\"", file=sys.stderr)
+            exit(1)
+    exit(0)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,34 @@
+#!/usr/bin/env python3
+
+from argparse import ArgumentParser
+from multiprocessing import shared_memory
+from pathlib import Path
+
+import subprocess
+import sys
+
+def main() -> None:
+    parser = ArgumentParser(description="Read the assertion metrics published by a test program.")
+    parser.add_argument("READER", help="The metrics reader to use.", type=Path)
+    parser.add_argument("PROGRAM", help="The test program to run. It receives the segment name as its argument.",
+                        type=Path)
+    parser.add_argument("SEGMENT", help="The name of the shared-memory segment to create.", type=str)
+    parser.add_argument("EXPECTED", nargs="*", default="", help="The output that the reader should produce.",
+                        type=str)
+    args = parser.parse_args()
+    subprocess.run([ args.PROGRAM, args.SEGMENT ], capture_output=True)
+    completed = subprocess.run([ args.READER, "--prometheus", args.SEGMENT ], capture_output=True)
+    # Segments outlive the program, so the test removes its own.
+    try:
+        shared_memory.SharedMemory(name=args.SEGMENT).unlink()
+    except OSError:
+        pass
+    output = completed.stdout.decode("utf-8")
+    for text in args.EXPECTED:
+        if completed.returncode != 0 or text not in output:
+            print(f"\"{text}\" was not in \"{output.strip()}\"", file=sys.stderr)
+            exit(1)
+    exit(0)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,33 @@
+#!/usr/bin/env python3
+
+from argparse import ArgumentParser
+from pathlib import Path
+
+import subprocess
+import sys
+import os
+
+if os.name == "posix":
+    import resource
+
+def main() -> None:
+    if os.name == "posix":
+        try:
+            resource.setrlimit(resource.RLIMIT_CORE, (0, 0))
+        except:
+            pass
+    parser = ArgumentParser(description="Symbolize the compact assertion report of a test program.")
+    parser.add_argument("SYMBOLIZER", help="The symbolizer to use.", type=Path)
+    parser.add_argument("PROGRAM", help="The test program to run. This is also used as the side table.", type=Path)
+    parser.add_argument("EXPECTED", help="The output that the symbolizer should produce.", type=str)
+    args = parser.parse_args()
+    report = subprocess.run([ args.PROGRAM ], capture_output=True).stderr
+    completed = subprocess.run([ args.SYMBOLIZER, args.PROGRAM ], input=report, capture_output=True)
+    output = completed.stdout.decode("utf-8")
+    if completed.returncode != 0 or args.EXPECTED not in output:
+        print(f"\"{args.EXPECTED}\" was not in \"{output.strip()}\"", file=sys.stderr)
+        exit(1)
+    exit(0)
+
+if __name__ == "__main__":
+    main()
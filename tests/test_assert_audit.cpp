@@ -0,0 +1,8 @@
+#define MEGATECH_ASSERTIONS_LEVEL MEGATECH_ASSERTIONS_LEVEL_AUDIT
+#include <megatech/assertions.hpp>
+
+int main() {
+  MEGATECH_ASSERT(1 == 1);
+  MEGATECH_ASSERT_AUDIT(1 != 1);
+  return 0;
+}
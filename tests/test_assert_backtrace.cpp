@@ -0,0 +1,14 @@
+#include <megatech/assertions.hpp>
+
+[[gnu::noinline]] void validate(const int value) {
+  MEGATECH_PRECONDITION(value != 1);
+}
+
+[[gnu::noinline]] void caller(const int value) {
+  validate(value);
+}
+
+int main() {
+  caller(1);
+  return 0;
+}
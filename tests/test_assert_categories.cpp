@@ -0,0 +1,27 @@
+#define MEGATECH_ASSERTIONS_CATEGORIES (storage_assertions)
+#include <megatech/assertions.hpp>
+
+#include <cstdint>
+
+namespace {
+
+  constexpr auto storage_assertions = std::uint_least64_t{ 1 } << 0;
+  constexpr auto network_assertions = std::uint_least64_t{ 1 } << 1;
+
+  enum class subsystem : std::uint_least64_t {
+    storage = storage_assertions,
+    network = network_assertions
+  };
+
+}
+
+int main() {
+  auto evaluated = 0;
+  auto rendered = 0;
+  MEGATECH_ASSERT_IN(network_assertions, (++evaluated, 1 != 1));
+  MEGATECH_ASSERT_IN_MSG(network_assertions, (++evaluated, 1 != 1), "%d", ++rendered);
+  MEGATECH_ASSERT_IN_MSG_PRINTF(subsystem::network, (++evaluated, 1 != 1), "%d", ++rendered);
+  MEGATECH_ASSERT_IN(subsystem::storage, ++evaluated == 1);
+  MEGATECH_ASSERT_IN(storage_assertions | network_assertions, evaluated == 1 && rendered == 0 && 1 != 1);
+  return 0;
+}
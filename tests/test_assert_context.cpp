@@ -0,0 +1,19 @@
+#include <megatech/assertions.hpp>
+
+#include <string_view>
+
+void validate(const int shard, const int value) {
+  MEGATECH_ASSERT_CONTEXT("shard {}", shard);
+  MEGATECH_ASSERT(value >= 0);
+}
+
+int main() {
+  const auto request = std::string_view{ "request-42" };
+  MEGATECH_ASSERT_CONTEXT("request {} attempt {}", request, 2);
+  {
+    MEGATECH_ASSERT_CONTEXT("finished scope");
+  }
+  validate(7, 1);
+  validate(3, -1);
+  return 0;
+}
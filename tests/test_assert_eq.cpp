@@ -0,0 +1,14 @@
+#include <megatech/assertions.hpp>
+
+int main() {
+  auto evaluated = 0;
+  const auto next = [&evaluated]() { return ++evaluated; };
+  MEGATECH_ASSERT_EQ(next(), 1);
+  MEGATECH_ASSERT_NE(next(), 1);
+  MEGATECH_ASSERT_LT(next(), 4);
+  MEGATECH_ASSERT_LE(evaluated, 3);
+  MEGATECH_ASSERT_GT(next(), 3);
+  MEGATECH_ASSERT_GE(evaluated, 4);
+  MEGATECH_ASSERT_EQ(next(), 4);
+  return 0;
+}
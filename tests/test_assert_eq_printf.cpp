@@ -0,0 +1,10 @@
+#define MEGATECH_ASSERTIONS_FORMAT_UNAVAILABLE (1)
+#include <megatech/assertions.hpp>
+
+#include <string>
+
+int main() {
+  const auto value = std::string{ "test" };
+  MEGATECH_ASSERT_EQ(value, "passed");
+  return 0;
+}
@@ -0,0 +1,13 @@
+#include <csignal>
+
+#include <megatech/assertions.hpp>
+
+extern "C" void handler(int) {
+  MEGATECH_ASSERT(1 != 1);
+}
+
+int main() {
+  std::signal(SIGINT, handler);
+  std::raise(SIGINT);
+  return 0;
+}
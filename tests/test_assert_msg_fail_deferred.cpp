@@ -0,0 +1,12 @@
+#define MEGATECH_ASSERTIONS_DEFERRED_FORMAT (1)
+#include <megatech/assertions.hpp>
+
+#include <string_view>
+
+int main() {
+  const auto unsigned_value = 42u;
+  const auto view = std::string_view{ "passed" };
+  MEGATECH_SOFT_ASSERT_MSG_FORMAT(1 != 1, "soft {} {}", "test", view);
+  MEGATECH_ASSERT_MSG_FORMAT(1 != 1, "{} {} {:x} {} {} {} {}", "test", view, unsigned_value, -7, true, 'c', 0.1f);
+  return 0;
+}
@@ -0,0 +1,6 @@
+#include <megatech/assertions/slim.hpp>
+
+int main() {
+  MEGATECH_ASSERT_MSG(1 != 1, "test %s", "passed");
+  return 0;
+}
@@ -0,0 +1,33 @@
+#include <megatech/assertions/ranges.hpp>
+
+#include <cstdint>
+
+#include <array>
+#include <limits>
+#include <vector>
+
+int main() {
+  auto indices = std::vector<std::uint32_t>(1000);
+  for (auto i = std::size_t{ 0 }; i < indices.size(); ++i)
+  {
+    indices[i] = i;
+  }
+  MEGATECH_ASSERT_SORTED(indices);
+  MEGATECH_ASSERT_ALL_IN_RANGE(indices, 0, indices.size());
+  MEGATECH_ASSERT_ALL(indices, [](const std::uint32_t index) { return index < 1000; });
+  // Bounds that the element type can't represent must not be narrowed.
+  MEGATECH_ASSERT_ALL_IN_RANGE(indices, -1, 1000);
+  MEGATECH_ASSERT_ALL_IN_RANGE(indices, 0, std::uint64_t{ 1 } << 40);
+  const auto bytes = std::array<std::uint8_t, 4>{ 1, 2, 3, 255 };
+  MEGATECH_ASSERT_ALL_IN_RANGE(bytes, 0, 256);
+  const auto halves = std::array<float, 2>{ 0.5f, 16777216.0f };
+  MEGATECH_ASSERT_ALL_IN_RANGE(halves, 0, 16777217);
+  const auto shorts = std::array<short, 4>{ 1, 2, 3, 4 };
+  MEGATECH_ASSERT_SORTED(shorts);
+  auto samples = std::vector<float>(1000, 0.5f);
+  MEGATECH_ASSERT_ALL_FINITE(samples);
+  samples[300] = std::numeric_limits<float>::infinity();
+  samples[700] = std::numeric_limits<float>::quiet_NaN();
+  MEGATECH_ASSERT_ALL_FINITE(samples);
+  return 0;
+}
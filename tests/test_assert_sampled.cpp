@@ -0,0 +1,15 @@
+#include <megatech/assertions.hpp>
+
+int main() {
+  auto masked = 0;
+  auto counted = 0;
+  auto always = 0;
+  for (auto i = 0; i < 16; ++i)
+  {
+    MEGATECH_ASSERT_SAMPLED(++masked > 0, 4);
+    MEGATECH_ASSERT_SAMPLED_MSG_PRINTF(++counted > 0, 3, "%d", i);
+    MEGATECH_ASSERT_SAMPLED(++always > 0, 0);
+  }
+  MEGATECH_ASSERT_SAMPLED(masked != 4 || counted != 6 || always != 16, 2);
+  return 0;
+}
@@ -0,0 +1,14 @@
+#include <cstdio>
+
+#include <megatech/assertions.hpp>
+
+void handler(const megatech::assertion_failure& failure) noexcept {
+  std::fprintf(stderr, "Handled \"%s\" with the message \"%s\".\n", failure.site->expression,
+               failure.message ? failure.message : "");
+}
+
+int main() {
+  megatech::set_assertion_failure_handler(handler);
+  MEGATECH_ASSERT_MSG_PRINTF(1 != 1, "test %s", "passed");
+  return 0;
+}
@@ -0,0 +1,11 @@
+#include <megatech/assertions/journal.hpp>
+
+int main(int argc, char** argv) {
+  if (argc < 2 || !megatech::open_assertion_journal(argv[1], 4))
+  {
+    return 0;
+  }
+  MEGATECH_SOFT_ASSERT(1 != 1);
+  MEGATECH_ASSERT(2 != 2);
+  return 0;
+}
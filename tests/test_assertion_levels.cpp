@@ -0,0 +1,11 @@
+#define MEGATECH_ASSERTIONS_LEVEL MEGATECH_ASSERTIONS_LEVEL_DEFAULT
+#include <megatech/assertions.hpp>
+
+int main() {
+  auto evaluated = 0;
+  MEGATECH_ASSERT_AUDIT((++evaluated, 1 != 1));
+  MEGATECH_ASSERT_AUDIT_MSG((++evaluated, 1 != 1), "%d", ++evaluated);
+  MEGATECH_ASSERT_AXIOM((++evaluated, 1 != 1));
+  MEGATECH_ASSERT(evaluated == 0 && 1 != 1);
+  return 0;
+}
@@ -0,0 +1,15 @@
+#define MEGATECH_ASSERTIONS_PROFILING (1)
+#include <megatech/assertions/metrics.hpp>
+
+int main(int argc, char** argv) {
+  if (argc < 2 || !megatech::open_assertion_metrics(argv[1], 16))
+  {
+    return 1;
+  }
+  for (auto i = 0; i < 3; ++i)
+  {
+    MEGATECH_SOFT_ASSERT(i < 0);
+  }
+  megatech::update_assertion_metrics(megatech::assertion_sites());
+  return 0;
+}
@@ -0,0 +1,8 @@
+#include <megatech/assertions/module.hpp>
+
+import megatech.assertions;
+
+int main() {
+  MEGATECH_ASSERT(1 != 1);
+  return 0;
+}
@@ -0,0 +1,44 @@
+#define MEGATECH_ASSERTIONS_PROFILING (1)
+#define MEGATECH_ASSERTIONS_PROFILE_CYCLES (1)
+#include <megatech/assertions.hpp>
+
+#include <cstdint>
+#include <cstring>
+
+#include <thread>
+
+void check(const int value) {
+  MEGATECH_ASSERT(value >= 0);
+}
+
+int main() {
+  for (auto i = 0; i < 100; ++i)
+  {
+    check(i);
+  }
+  auto worker = std::thread{ []() {
+    for (auto i = 0; i < 50; ++i)
+    {
+      check(i);
+      MEGATECH_ASSERT_LT(i, 50);
+    }
+  } };
+  worker.join();
+  auto checks = std::uint_least64_t{ 0 };
+  auto comparisons = std::uint_least64_t{ 0 };
+  auto profiles = 0;
+  for (auto profile = megatech::assertion_profiles(); profile; profile = profile->next)
+  {
+    const auto evaluations = profile->evaluations.load();
+    if (std::strcmp(profile->site->expression, "value >= 0") == 0)
+    {
+      checks += evaluations;
+    }
+    else
+    {
+      comparisons += evaluations;
+    }
+    ++profiles;
+  }
+  return !(checks == 150 && comparisons == 50 && profiles == 3);
+}
@@ -0,0 +1,33 @@
+#include <cstring>
+
+#include <megatech/assertions.hpp>
+
+template <typename Type>
+void templated(const Type value) {
+  MEGATECH_ASSERT(value == Type{ 2 });
+}
+
+int main() {
+  MEGATECH_ASSERT(1 == 1);
+  MEGATECH_ASSERT_MSG_PRINTF(3 == 3, "test %s", "failed");
+  templated(2);
+  templated(2.0);
+  auto found = 0;
+  for (const auto& site : megatech::assertion_sites())
+  {
+    if (std::strcmp(site.expression, "1 == 1") == 0 && !site.format)
+    {
+      found += 1;
+    }
+    else if (std::strcmp(site.expression, "3 == 3") == 0 && std::strcmp(site.format, "test %s") == 0)
+    {
+      found += 10;
+    }
+    else if (std::strcmp(site.expression, "value == Type{ 2 }") == 0)
+    {
+      found += 100;
+    }
+  }
+  // Older versions of GCC silently place sites in template instantiations outside of the registry section.
+  return found != 11 && found != 211;
+}
@@ -0,0 +1,24 @@
+#include <megatech/assertions/testing.hpp>
+
+#include <cstring>
+
+void check(const int value) {
+  MEGATECH_ASSERT_MSG_PRINTF(value >= 0, "value %d is negative", value);
+}
+
+int main() {
+  auto failures = 0;
+  for (auto i = 0; i < 1000; ++i)
+  {
+    failures += megatech::testing::expect_assertion_failure([i]() { check(-i - 1); }, "value >= 0",
+                                                            "is negative");
+  }
+  auto failure = megatech::testing::captured_assertion_failure{ };
+  const auto compared = megatech::testing::capture_assertion_failure([]() { MEGATECH_ASSERT_EQ(2 + 2, 5); }, failure);
+  const auto passed = megatech::testing::capture_assertion_failure([]() { check(1); }, failure);
+  const auto ok = failures == 1000 && compared && !passed && std::strcmp(failure.message.data(), "4 == 5") == 0 &&
+                  failure.line == 17;
+  // Failures outside of a helper still abort the program.
+  MEGATECH_ASSERT(!ok);
+  return 0;
+}
@@ -0,0 +1,22 @@
+#include <megatech/assertions/testing.hpp>
+
+#include <cstdio>
+
+void check(const int value) {
+  MEGATECH_ASSERT_CONTEXT("checking {}", value);
+  MEGATECH_ASSERT(value >= 0);
+}
+
+void handler(const megatech::assertion_failure& failure) noexcept {
+  std::fprintf(stderr, "Reported \"%s\" with a context depth of %zu.\n", failure.site->expression,
+               failure.context_depth);
+}
+
+int main() {
+  MEGATECH_ASSERT_CONTEXT("main");
+  // The trapped failure skips the destructor of the context in check(), so the trap must remove it instead.
+  const auto trapped = megatech::testing::expect_assertion_failure([]() { check(-1); }, "value >= 0");
+  megatech::set_assertion_failure_handler(handler);
+  MEGATECH_ASSERT(!trapped);
+  return 0;
+}
@@ -0,0 +1,6 @@
+#include <megatech/assertions.hpp>
+
+int main() {
+  MEGATECH_ASSUME(1 != 1);
+  return 0;
+}
@@ -0,0 +1,33 @@
+#define MEGATECH_ASSERTIONS_DISABLED (1)
+#define MEGATECH_ASSERTIONS_ASSUME_CONTRACTS (1)
+#include <megatech/assertions.hpp>
+
+#include <cstddef>
+
+int sum(const int *const values, const std::size_t size) {
+  MEGATECH_PRECONDITION(size % 4 == 0);
+  MEGATECH_PRECONDITION_MSG(values != nullptr, "values must not be null");
+  auto result = 0;
+  for (auto i = std::size_t{ 0 }; i < size; ++i)
+  {
+    result += values[i];
+  }
+  MEGATECH_POSTCONDITION(result >= 0);
+  return result;
+}
+
+int calls = 0;
+
+bool is_valid(const int value) {
+  ++calls;
+  return value > 0;
+}
+
+int main() {
+  const int values[] = { 1, 2, 3, 4 };
+  MEGATECH_ASSUME(sum(values, 4) == 10);
+  // Disabled contracts must never be evaluated, even on compilers that evaluate MEGATECH_ASSUME.
+  MEGATECH_PRECONDITION(is_valid(values[0]));
+  MEGATECH_POSTCONDITION_MSG(is_valid(values[1]), "values must be positive");
+  return sum(values, 4) == 10 && calls == 0 ? 0 : 1;
+}
@@ -0,0 +1,21 @@
+#include <megatech/assertions/checked.hpp>
+
+#include <array>
+#include <vector>
+
+constexpr int sum(const megatech::checked_span<const int> values) {
+  return values.front() + values[1] + values.back();
+}
+
+int main() {
+  constexpr auto constants = std::array<int, 3>{ 1, 2, 3 };
+  static_assert(sum(constants) == 6);
+  static_assert(megatech::checked_at(constants, 2) == 3);
+  auto values = std::vector<int>(4);
+  megatech::checked_at(values, 3) = 1;
+  auto view = megatech::checked_span{ values };
+  view[2] = view[3];
+  view.front() = view.back();
+  const auto index = values.size() + values[0];
+  return megatech::checked_at(values, index);
+}
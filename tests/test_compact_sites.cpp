@@ -0,0 +1,7 @@
+#define MEGATECH_ASSERTIONS_COMPACT_SITES (1)
+#include <megatech/assertions.hpp>
+
+int main() {
+  MEGATECH_ASSERT(1 != 1);
+  return 0;
+}
@@ -0,0 +1,23 @@
+#include <megatech/assertions.hpp>
+
+#include <type_traits>
+
+constexpr int parse_digit(const char c) {
+  MEGATECH_PRECONDITION(c >= '0' && c <= '9');
+  MEGATECH_ASSERT_SAMPLED(c != '\0', 4);
+  MEGATECH_SOFT_ASSERT(c != 'x');
+  return c - '0';
+}
+
+template <char C>
+concept constant_digit = requires { typename std::integral_constant<int, parse_digit(C)>; };
+
+static_assert(parse_digit('7') == 7);
+static_assert(constant_digit<'0'>);
+// A failing assertion during constant evaluation is a compile error, so this isn't a constant expression.
+static_assert(!constant_digit<'x'>);
+
+int main(int argc, char**) {
+  // At run-time the assertion behaves as usual.
+  return parse_digit(static_cast<char>('x' + argc - 1));
+}
@@ -0,0 +1,24 @@
+#include <thread>
+#include <barrier>
+#include <vector>
+
+#include <megatech/assertions.hpp>
+
+#include "config.hpp"
+
+std::barrier ready{ CONFIG_TEST_SUMMARY_THREADS + 1 };
+
+void worker() {
+  ready.arrive_and_wait();
+  MEGATECH_ASSERT(1 != 1);
+}
+
+int main() {
+  auto threads = std::vector<std::jthread>{ };
+  for (auto i = 0; i < CONFIG_TEST_SUMMARY_THREADS; ++i)
+  {
+    threads.emplace_back(worker);
+  }
+  ready.arrive_and_wait();
+  return 0;
+}
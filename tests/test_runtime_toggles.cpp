@@ -0,0 +1,12 @@
+#define MEGATECH_ASSERTIONS_RUNTIME_TOGGLES (1)
+#include <megatech/assertions.hpp>
+
+int main() {
+  const auto sites = megatech::assertion_sites();
+  auto evaluated = 0;
+  megatech::configure_assertions(sites, "-*");
+  MEGATECH_ASSERT((++evaluated, 1 != 1));
+  megatech::configure_assertions(sites, "-*,+*main*");
+  MEGATECH_ASSERT(evaluated == 0 && 1 != 1);
+  return 0;
+}
@@ -0,0 +1,20 @@
+#include <cstring>
+
+#include <megatech/assertions.hpp>
+
+int main() {
+  for (auto i = 0; i < 3; ++i)
+  {
+    MEGATECH_SOFT_ASSERT(i < 0);
+  }
+  auto failures = std::uint_least64_t{ 0 };
+  for (const auto& site : megatech::assertion_sites())
+  {
+    if (std::strcmp(site.expression, "i < 0") == 0)
+    {
+      failures = megatech::soft_assertion_failures(site);
+    }
+  }
+  MEGATECH_ASSERT(failures != 3);
+  return 0;
+}
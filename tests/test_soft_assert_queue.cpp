@@ -0,0 +1,23 @@
+#include <cstdio>
+
+#include <megatech/assertions.hpp>
+
+thread_local bool t_main_thread{ false };
+
+void handler(const megatech::assertion_failure& failure) noexcept {
+  std::fprintf(stderr, "Reported \"%s\" %s.\n", failure.site->expression,
+               t_main_thread ? "on the failing thread" : "in the background");
+}
+
+int main() {
+  t_main_thread = true;
+  megatech::set_assertion_failure_handler(handler);
+  for (auto i = 0; i < 3; ++i)
+  {
+    MEGATECH_SOFT_ASSERT(i < 0);
+  }
+  megatech::flush_soft_assertion_failures();
+  std::fprintf(stderr, "Dropped %llu failures.\n",
+               static_cast<unsigned long long>(megatech::dropped_soft_assertion_failures()));
+  return 0;
+}
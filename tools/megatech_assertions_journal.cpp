@@ -0,0 +1,160 @@
+/**
+ * @file megatech_assertions_journal.cpp
+ * @brief Assertion Failure Journal Reader
+ * @details This prints every complete record in an assertion failure journal, from oldest to newest, in the same
+ *          format as the library's default failure reports. Each report is prefixed with its sequence number, time,
+ *          and thread.
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2024
+ */
+#include <megatech/assertions/journal.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+  std::vector<char> read_file(const char* path) {
+    auto file = std::ifstream{ path, std::ios::binary };
+    if (!file)
+    {
+      throw std::runtime_error{ std::string{ "Failed to open \"" } + path + "\"." };
+    }
+    return std::vector<char>{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{ } };
+  }
+
+  template <typename Type>
+  Type read_at(const std::string_view data, const std::size_t offset) {
+    if (offset > data.size() || data.size() - offset < sizeof(Type))
+    {
+      throw std::runtime_error{ "The journal is truncated." };
+    }
+    auto result = Type{ };
+    std::memcpy(&result, data.data() + offset, sizeof(Type));
+    return result;
+  }
+
+  template <std::size_t Size>
+  std::string_view field(const std::array<char, Size>& value) {
+    const auto end = std::find(value.begin(), value.end(), '\0');
+    return std::string_view{ value.data(), static_cast<std::size_t>(end - value.begin()) };
+  }
+
+  std::vector<megatech::assertion_journal_record> parse_journal(const std::string_view data) {
+    using megatech::assertion_journal_header;
+    using megatech::assertion_journal_record;
+    const auto header = read_at<assertion_journal_header>(data, 0);
+    if (header.magic != assertion_journal_header::magic_value)
+    {
+      throw std::runtime_error{ "The file isn't an assertion journal." };
+    }
+    if (header.version != assertion_journal_header::current_version ||
+        header.record_size != sizeof(assertion_journal_record))
+    {
+      throw std::runtime_error{ "The journal was written in an unsupported format." };
+    }
+    auto result = std::vector<assertion_journal_record>{ };
+    for (auto i = std::uint64_t{ 0 }; i < header.capacity; ++i)
+    {
+      const auto offset = sizeof(header) + i * sizeof(assertion_journal_record);
+      const auto record = read_at<assertion_journal_record>(data, offset);
+      // Records with a sequence number of 0 are either empty or were interrupted while being written.
+      if (record.sequence)
+      {
+        result.push_back(record);
+      }
+    }
+    std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) { return a.sequence < b.sequence; });
+    return result;
+  }
+
+  void print_time(std::ostream& out, const std::int64_t timestamp) {
+    const auto seconds = static_cast<std::time_t>(timestamp / 1'000'000'000);
+    auto time = std::tm{ };
+    auto text = std::array<char, 64>{ };
+    if (gmtime_r(&seconds, &time) && std::strftime(text.data(), text.size(), "%Y-%m-%dT%H:%M:%S", &time))
+    {
+      auto nanoseconds = std::array<char, 16>{ };
+      std::snprintf(nanoseconds.data(), nanoseconds.size(), ".%09lld",
+                    static_cast<long long>(timestamp % 1'000'000'000));
+      out << text.data() << nanoseconds.data() << "Z";
+    }
+    else
+    {
+      out << timestamp;
+    }
+  }
+
+  void print_record(std::ostream& out, const megatech::assertion_journal_record& record) {
+    using megatech::assertion_journal_record;
+    const auto kind = record.flags & assertion_journal_record::soft_flag ? "soft assertion" : "assertion";
+    out << "#" << record.sequence << " ";
+    print_time(out, record.timestamp);
+    out << " thread 0x" << std::hex << record.thread << std::dec << ": ";
+    if (record.file_name[0])
+    {
+      out << field(record.file_name) << ":" << record.line << ": " << field(record.function_name);
+    }
+    else
+    {
+      auto id = std::array<char, 16>{ };
+      std::snprintf(id.data(), id.size(), "0x%08x", static_cast<unsigned>(record.id));
+      out << "[" << id.data() << "]";
+    }
+    out << ": The " << kind;
+    if (record.expression[0])
+    {
+      out << " \"" << field(record.expression) << "\"";
+    }
+    if (record.flags & assertion_journal_record::error_flag)
+    {
+      out << " failed.\nThe following error occurred during " << kind << " failure processing: \""
+          << field(record.message) << "\"\n";
+    }
+    else if (record.message[0])
+    {
+      out << " failed with the message \"" << field(record.message) << "\".\n";
+    }
+    else
+    {
+      out << " failed.\n";
+    }
+  }
+
+}
+
+int main(int argc, char** argv) {
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " JOURNAL\n"
+              << "Print every assertion failure recorded in a journal, from oldest to newest.\n";
+    return EXIT_FAILURE;
+  }
+  try
+  {
+    const auto data = read_file(argv[1]);
+    for (const auto& record : parse_journal(std::string_view{ data.data(), data.size() }))
+    {
+      print_record(std::cout, record);
+    }
+  }
+  catch (const std::exception& err)
+  {
+    std::cerr << argv[0] << ": " << err.what() << "\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,277 @@
+/**
+ * @file megatech_assertions_metrics.cpp
+ * @brief Assertion Metrics Reader
+ * @details This prints the records of a live assertion metrics segment, either as a table or in the Prometheus text
+ *          exposition format. The publishing process is never paused. Records that are being written are reread until
+ *          a consistent copy is available.
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2024
+ */
+#include <megatech/assertions/metrics.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+  // Readers retry a record that's being written this many times before giving up on it.
+  constexpr auto read_attempts = 1000;
+
+  template <std::size_t Size>
+  std::string_view field(const std::array<char, Size>& value) {
+    const auto end = std::find(value.begin(), value.end(), '\0');
+    return std::string_view{ value.data(), static_cast<std::size_t>(end - value.begin()) };
+  }
+
+  // A read-only mapping of a metrics segment.
+  class metrics_mapping final {
+  private:
+    void* m_data{ MAP_FAILED };
+    std::size_t m_size{ };
+  public:
+    explicit metrics_mapping(const char* name) {
+      const auto fd = shm_open(name, O_RDONLY, 0);
+      if (fd < 0)
+      {
+        throw std::runtime_error{ std::string{ "Failed to open \"" } + name + "\"." };
+      }
+      struct stat status{ };
+      if (!fstat(fd, &status))
+      {
+        m_size = static_cast<std::size_t>(status.st_size);
+      }
+      if (m_size >= sizeof(megatech::assertion_metrics_header))
+      {
+        m_data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+      }
+      close(fd);
+      if (m_data == MAP_FAILED)
+      {
+        throw std::runtime_error{ "The segment isn't an assertion metrics segment." };
+      }
+    }
+    metrics_mapping(const metrics_mapping& other) = delete;
+    metrics_mapping(metrics_mapping&& other) = delete;
+
+    ~metrics_mapping() noexcept {
+      munmap(m_data, m_size);
+    }
+
+    metrics_mapping& operator=(const metrics_mapping& rhs) = delete;
+    metrics_mapping& operator=(metrics_mapping&& rhs) = delete;
+
+    const megatech::assertion_metrics_header& header() const {
+      const auto& result = *static_cast<const megatech::assertion_metrics_header*>(m_data);
+      if (result.magic != megatech::assertion_metrics_header::magic_value)
+      {
+        throw std::runtime_error{ "The segment isn't an assertion metrics segment." };
+      }
+      if (result.version != megatech::assertion_metrics_header::current_version ||
+          result.record_size != sizeof(megatech::assertion_metrics_record) ||
+          (m_size - sizeof(result)) / sizeof(megatech::assertion_metrics_record) < result.capacity)
+      {
+        throw std::runtime_error{ "The segment was written in an unsupported format." };
+      }
+      return result;
+    }
+
+    const megatech::assertion_metrics_record* records() const {
+      return reinterpret_cast<const megatech::assertion_metrics_record*>(&header() + 1);
+    }
+  };
+
+  std::uint64_t load_sequence(const megatech::assertion_metrics_record& record) {
+    // Atomic loads never write, so this is safe on a read-only mapping.
+    return std::atomic_ref{ const_cast<std::uint64_t&>(record.sequence) }.load(std::memory_order_acquire);
+  }
+
+  // Copy every published record with the sequence lock protocol. Records are returned in the order of the table.
+  std::vector<megatech::assertion_metrics_record> read_records(const metrics_mapping& mapping) {
+    const auto& header = mapping.header();
+    const auto records = mapping.records();
+    auto result = std::vector<megatech::assertion_metrics_record>{ };
+    for (auto i = std::uint64_t{ 0 }; i < header.capacity; ++i)
+    {
+      for (auto attempt = 0; attempt < read_attempts; ++attempt)
+      {
+        const auto before = load_sequence(records[i]);
+        if (before & 1)
+        {
+          continue;
+        }
+        auto copy = megatech::assertion_metrics_record{ };
+        std::memcpy(&copy, &records[i], sizeof(copy));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (load_sequence(records[i]) == before)
+        {
+          if (before && copy.site)
+          {
+            result.push_back(copy);
+          }
+          break;
+        }
+      }
+    }
+    return result;
+  }
+
+  std::string site_id(const megatech::assertion_metrics_record& record) {
+    auto id = std::array<char, 16>{ };
+    std::snprintf(id.data(), id.size(), "0x%08x", static_cast<unsigned>(record.id));
+    return id.data();
+  }
+
+  void print_table(std::ostream& out, const megatech::assertion_metrics_header& header,
+                   const std::vector<megatech::assertion_metrics_record>& records) {
+    out << "Assertion metrics of process " << header.process << ":\n"
+        << "            failures          evaluations               cycles  site\n";
+    for (const auto& record : records)
+    {
+      auto counts = std::array<char, 80>{ };
+      std::snprintf(counts.data(), counts.size(), "%20llu %20llu %20llu  ",
+                    static_cast<unsigned long long>(record.failures),
+                    static_cast<unsigned long long>(record.evaluations),
+                    static_cast<unsigned long long>(record.cycles));
+      out << counts.data();
+      if (record.file_name[0])
+      {
+        out << field(record.file_name) << ":" << record.line << ": " << field(record.function_name);
+      }
+      else
+      {
+        out << "[" << site_id(record) << "]";
+      }
+      if (record.expression[0])
+      {
+        out << ": \"" << field(record.expression) << "\"";
+      }
+      out << "\n";
+    }
+    if (header.overflow)
+    {
+      out << header.overflow << " updates didn't fit in the segment.\n";
+    }
+  }
+
+  void print_label_value(std::ostream& out, const std::string_view value) {
+    out << "\"";
+    for (const auto c : value)
+    {
+      switch (c)
+      {
+      case '\\':
+        out << "\\\\";
+        break;
+      case '"':
+        out << "\\\"";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      default:
+        out << c;
+        break;
+      }
+    }
+    out << "\"";
+  }
+
+  void print_labels(std::ostream& out, const megatech::assertion_metrics_record& record) {
+    out << "{";
+    if (record.file_name[0])
+    {
+      out << "file=";
+      print_label_value(out, field(record.file_name));
+      out << ",line=\"" << record.line << "\",function=";
+      print_label_value(out, field(record.function_name));
+    }
+    else
+    {
+      out << "id=\"" << site_id(record) << "\"";
+    }
+    if (record.expression[0])
+    {
+      out << ",expression=";
+      print_label_value(out, field(record.expression));
+    }
+    out << "}";
+  }
+
+  void print_prometheus(std::ostream& out, const megatech::assertion_metrics_header& header,
+                        const std::vector<megatech::assertion_metrics_record>& records) {
+    struct metric final {
+      const char* name;
+      const char* help;
+      std::uint64_t megatech::assertion_metrics_record::* value;
+    };
+    constexpr auto metrics = std::array<metric, 3>{ {
+      { "megatech_assertion_failures_total", "The number of times that a soft assertion failed.",
+        &megatech::assertion_metrics_record::failures },
+      { "megatech_assertion_evaluations_total", "The number of times that a profiled assertion was evaluated.",
+        &megatech::assertion_metrics_record::evaluations },
+      { "megatech_assertion_cycles_total", "The time spent evaluating a profiled assertion.",
+        &megatech::assertion_metrics_record::cycles }
+    } };
+    for (const auto& metric : metrics)
+    {
+      out << "# HELP " << metric.name << " " << metric.help << "\n"
+          << "# TYPE " << metric.name << " counter\n";
+      for (const auto& record : records)
+      {
+        out << metric.name;
+        print_labels(out, record);
+        out << " " << record.*metric.value << "\n";
+      }
+    }
+    out << "# HELP megatech_assertion_metrics_overflow_total The number of site updates that didn't fit.\n"
+        << "# TYPE megatech_assertion_metrics_overflow_total counter\n"
+        << "megatech_assertion_metrics_overflow_total " << header.overflow << "\n";
+  }
+
+}
+
+int main(int argc, char** argv) {
+  const auto prometheus = argc == 3 && std::string_view{ argv[1] } == "--prometheus";
+  if (argc != 2 && !prometheus)
+  {
+    std::cerr << "Usage: " << argv[0] << " [--prometheus] SEGMENT\n"
+              << "Print the assertion metrics published in a shared-memory segment.\n";
+    return EXIT_FAILURE;
+  }
+  try
+  {
+    const auto mapping = metrics_mapping{ argv[argc - 1] };
+    const auto records = read_records(mapping);
+    if (prometheus)
+    {
+      print_prometheus(std::cout, mapping.header(), records);
+    }
+    else
+    {
+      print_table(std::cout, mapping.header(), records);
+    }
+  }
+  catch (const std::exception& err)
+  {
+    std::cerr << argv[0] << ": " << err.what() << "\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,221 @@
+/**
+ * @file megatech_assertions_symbolize.cpp
+ * @brief Compact Assertion Site Symbolizer
+ * @details This maps the IDs of compact assertion sites back to their file names, line numbers, function names, and
+ *          expressions. The side table is either an unstripped ELF binary or the raw contents of its
+ *          `megatech_assertion_symbols` section (e.g., as extracted by `objcopy --dump-section`).
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2024
+ */
+#include <megatech/assertions.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <elf.h>
+
+namespace {
+
+  constexpr auto symbol_section_name = std::string_view{ "megatech_assertion_symbols" };
+
+  struct site_symbol final {
+    std::uint32_t id{ };
+    std::uint32_t line{ };
+    std::string_view file_name{ };
+    std::string_view function_name{ };
+    std::string_view expression{ };
+  };
+
+  std::vector<char> read_file(const char* path) {
+    auto file = std::ifstream{ path, std::ios::binary };
+    if (!file)
+    {
+      throw std::runtime_error{ std::string{ "Failed to open \"" } + path + "\"." };
+    }
+    return std::vector<char>{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{ } };
+  }
+
+  template <typename Type>
+  Type read_at(const std::string_view data, const std::size_t offset) {
+    if (offset > data.size() || data.size() - offset < sizeof(Type))
+    {
+      throw std::runtime_error{ "The side table is truncated." };
+    }
+    auto result = Type{ };
+    std::memcpy(&result, data.data() + offset, sizeof(Type));
+    return result;
+  }
+
+  // Find the symbol section in an ELF file. Only files with the same byte order as the host are supported.
+  template <typename Header, typename SectionHeader>
+  std::string_view find_symbol_section(const std::string_view data) {
+    const auto header = read_at<Header>(data, 0);
+    const auto names = read_at<SectionHeader>(data, header.e_shoff + header.e_shstrndx * sizeof(SectionHeader));
+    for (auto i = std::size_t{ 0 }; i < header.e_shnum; ++i)
+    {
+      const auto section = read_at<SectionHeader>(data, header.e_shoff + i * sizeof(SectionHeader));
+      const auto name_offset = names.sh_offset + section.sh_name;
+      if (name_offset >= data.size())
+      {
+        throw std::runtime_error{ "The ELF section names are truncated." };
+      }
+      const auto name = std::string_view{ data.data() + name_offset };
+      if (name == symbol_section_name)
+      {
+        if (section.sh_offset > data.size() || data.size() - section.sh_offset < section.sh_size)
+        {
+          throw std::runtime_error{ "The symbol section is truncated." };
+        }
+        return data.substr(section.sh_offset, section.sh_size);
+      }
+    }
+    throw std::runtime_error{ "The ELF file doesn't contain any compact assertion sites." };
+  }
+
+  std::string_view find_table(const std::string_view data) {
+    if (data.size() < EI_NIDENT || std::memcmp(data.data(), ELFMAG, SELFMAG))
+    {
+      return data;
+    }
+    if (data[EI_CLASS] == ELFCLASS64)
+    {
+      return find_symbol_section<Elf64_Ehdr, Elf64_Shdr>(data);
+    }
+    return find_symbol_section<Elf32_Ehdr, Elf32_Shdr>(data);
+  }
+
+  std::vector<site_symbol> parse_table(const std::string_view table) {
+    using megatech::internal::base::compact_site_symbol_header;
+    auto result = std::vector<site_symbol>{ };
+    auto offset = std::size_t{ 0 };
+    while (offset + sizeof(std::uint32_t) <= table.size())
+    {
+      const auto header = read_at<compact_site_symbol_header>(table, offset);
+      // Every file name contains at least a NUL terminator, so an empty file name is padding between entries.
+      if (!header.file_name_size)
+      {
+        offset += sizeof(std::uint32_t);
+        continue;
+      }
+      auto current = offset + sizeof(compact_site_symbol_header);
+      const auto next_string = [&](const std::uint32_t size) {
+        if (!size || current > table.size() || table.size() - current < size)
+        {
+          throw std::runtime_error{ "The side table is corrupt." };
+        }
+        const auto string = table.substr(current, size - 1);
+        current += size;
+        return string;
+      };
+      auto symbol = site_symbol{ header.id, header.line };
+      symbol.file_name = next_string(header.file_name_size);
+      symbol.function_name = next_string(header.function_name_size);
+      symbol.expression = next_string(header.expression_size);
+      result.push_back(symbol);
+      constexpr auto alignment = alignof(compact_site_symbol_header);
+      offset = (current + alignment - 1) / alignment * alignment;
+    }
+    return result;
+  }
+
+  const site_symbol* find_symbol(const std::vector<site_symbol>& symbols, const std::uint32_t id) {
+    for (const auto& symbol : symbols)
+    {
+      if (symbol.id == id)
+      {
+        return &symbol;
+      }
+    }
+    return nullptr;
+  }
+
+  void print_location(std::ostream& out, const site_symbol& symbol) {
+    out << symbol.file_name << ":" << symbol.line << ": " << symbol.function_name;
+  }
+
+  // Compact reports begin with "[0x01234567]: The ". Those are rewritten into the usual report format. Every other
+  // line is copied unchanged.
+  void symbolize_line(std::ostream& out, const std::vector<site_symbol>& symbols, const std::string_view line) {
+    constexpr auto id_size = std::size_t{ 10 };
+    constexpr auto prefix = std::string_view{ "]: The " };
+    const auto id_string = line.substr(1, id_size);
+    if (line.size() > 1 + id_size + prefix.size() && line[0] == '[' && id_string.starts_with("0x") &&
+        line.substr(1 + id_size, prefix.size()) == prefix)
+    {
+      auto end = static_cast<char*>(nullptr);
+      const auto id_text = std::string{ id_string };
+      const auto id = std::strtoul(id_text.c_str(), &end, 16);
+      const auto rest = line.substr(1 + id_size + prefix.size());
+      const auto failed = rest.find(" failed");
+      const auto symbol = find_symbol(symbols, static_cast<std::uint32_t>(id));
+      if (symbol && end == id_text.c_str() + id_size && failed != std::string_view::npos)
+      {
+        print_location(out, *symbol);
+        out << ": The " << rest.substr(0, failed) << " \"" << symbol->expression << "\"" << rest.substr(failed)
+            << "\n";
+        return;
+      }
+    }
+    out << line << "\n";
+  }
+
+  int print_ids(const std::vector<site_symbol>& symbols, const int count, char** ids) {
+    auto result = EXIT_SUCCESS;
+    for (auto i = 0; i < count; ++i)
+    {
+      const auto id = static_cast<std::uint32_t>(std::strtoul(ids[i], nullptr, 16));
+      const auto symbol = find_symbol(symbols, id);
+      if (!symbol)
+      {
+        std::cerr << ids[i] << ": The ID wasn't found.\n";
+        result = EXIT_FAILURE;
+        continue;
+      }
+      std::cout << ids[i] << ": ";
+      print_location(std::cout, *symbol);
+      std::cout << ": \"" << symbol->expression << "\"\n";
+    }
+    return result;
+  }
+
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " TABLE [ID...]\n"
+              << "Map compact assertion site IDs to their locations. Without any IDs, assertion reports are read "
+              << "from standard input and symbolized.\n";
+    return EXIT_FAILURE;
+  }
+  try
+  {
+    const auto data = read_file(argv[1]);
+    const auto symbols = parse_table(find_table(std::string_view{ data.data(), data.size() }));
+    if (argc > 2)
+    {
+      return print_ids(symbols, argc - 2, argv + 2);
+    }
+    for (auto line = std::string{ }; std::getline(std::cin, line);)
+    {
+      symbolize_line(std::cout, symbols, line);
+    }
+  }
+  catch (const std::exception& err)
+  {
+    std::cerr << argv[0] << ": " << err.what() << "\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}